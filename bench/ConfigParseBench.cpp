@@ -0,0 +1,98 @@
+/**
+ * @file      ConfigParseBench.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Time to read large configurations.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <algorithm>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <unistd.h>
+#include "Config.hpp"
+#include "Util.hpp"
+
+using namespace std::chrono;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// Write config with @p hosts hosts in groups of 100 to @p path.
+void write_config(std::string const& path, std::size_t hosts)
+{
+    auto file = std::ofstream(path);
+    file << "BEGIN_CONFIG\n"
+         << "FIELD_ORDER: ALIAS FQHN ROLE PROTOCOL INTERVAL\n"
+         << "CONFIRM_RETRIES: 2\n"
+         << "CONFIRM_SPACING: 500\n"
+         << "END_CONFIG\n";
+
+    for (auto i = std::size_t(0); i < hosts; ++i)
+    {
+        if ((i % 100) == 0)
+        {
+            file << ((i == 0) ? "" : "END_GROUP\n")
+                 << "BEGIN_GROUP\n"
+                 << "NAME: Group" << i / 100 << "\n";
+        }
+        file << "BEGIN_HOST\n"
+             << "FQHN: 10." << ((i >> 16) & 0xff) << "." << ((i >> 8) & 0xff) << "." << (i & 0xff) << "\n"
+             << "ALIAS: host" << i << "\n"
+             << "ROLE: web\n"
+             << "PROTOCOL: TCP\n"
+             << "PORT: 80\n"
+             << "INTERVAL: 60\n"
+             << "END_HOST\n";
+    }
+    file << "END_GROUP\n";
+
+    if (!file)
+    {
+        abort("Failed to write benchmark config");
+    }
+}
+} // namespace
+
+// Usage: config_parse_bench [hosts [runs]]
+// Defaults to 100000 hosts, the best of 15 runs is reported.
+int main(int argc, char** argv)
+{
+    auto hosts = static_cast<std::size_t>((argc > 1) ? std::atol(argv[1]) : 100000);
+    auto runs  = (argc > 2) ? std::atoi(argv[2]) : 15;
+
+    auto path = std::string("/tmp/config_parse_bench.") + std::to_string(::getpid());
+    write_config(path, hosts);
+
+    auto best  = Clock::duration::max();
+    auto total = Clock::duration(0);
+    for (auto i = 0; i < runs; ++i)
+    {
+        auto start  = Clock::now();
+        auto config = read_config_file(path);
+        auto time   = Clock::now() - start;
+
+        best   = std::min(best, time);
+        total += time;
+        if (i == 0)
+        {
+            print_config_stats(std::cout, config);
+        }
+    }
+    ::unlink(path.c_str());
+
+    std::cout << "Read " << hosts << " hosts, " << runs << " runs: best "
+              << duration_cast<microseconds>(best).count() / 1000.0 << " ms, mean "
+              << duration_cast<microseconds>(total).count() / 1000.0 / runs << " ms\n";
+    return 0;
+}
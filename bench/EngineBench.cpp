@@ -0,0 +1,214 @@
+/**
+ * @file      EngineBench.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Throughput of the tcp probe engines.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <utility>
+#include <cstddef>
+#include <cstdlib>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include "Address.hpp"
+#include "FileDescriptor.hpp"
+#include "ProbeEngine.hpp"
+#include "TcpProbeEngine.hpp"
+#include "UringProbeEngine.hpp"
+#include "Util.hpp"
+
+using namespace std::chrono;
+
+namespace
+{
+using Clock   = std::chrono::steady_clock;
+using Factory = std::function<std::shared_ptr<ProbeEngine>(ProbeEngine::Completion)>;
+
+// Loopback listener accepting and closing connections on its own thread.
+class Listener
+{
+public:
+    Listener()
+        : fd_(::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0))
+        , running_(true)
+        , thread_()
+    {
+        auto addr = sockaddr_in();
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        auto len = socklen_t(sizeof(addr));
+        auto ptr = reinterpret_cast<sockaddr*>(&addr);
+        if (!fd_.is_valid() || (::bind(fd_.get(), ptr, len) < 0) ||
+            (::listen(fd_.get(), SOMAXCONN) < 0) || (::getsockname(fd_.get(), ptr, &len) < 0))
+        {
+            abort("Failed to setup listener");
+        }
+        port_ = ntohs(addr.sin_port);
+
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~Listener()
+    {
+        running_ = false;
+        thread_.join();
+    }
+
+    std::uint16_t get_port() const
+    {
+        return port_;
+    }
+
+private:
+    void run()
+    {
+        while (running_)
+        {
+            auto pfd = pollfd{fd_.get(), POLLIN, 0};
+            ::poll(&pfd, 1, 50);
+
+            auto conn = int(0);
+            while ((conn = ::accept4(fd_.get(), nullptr, nullptr, SOCK_CLOEXEC)) >= 0)
+            {
+                ::close(conn);
+            }
+        }
+    }
+
+    FileDescriptor    fd_;
+    std::uint16_t     port_;
+    std::atomic_bool  running_;
+    std::thread       thread_;
+};
+
+// Counts completions until all probes finished.
+class Counter
+{
+public:
+    explicit Counter(std::size_t expected)
+        : expected_(expected)
+        , finished_(0)
+        , available_(0)
+    {
+    }
+
+    void finish(ProbeResult const& result)
+    {
+        auto lock = std::lock_guard<std::mutex>(mtx_);
+        finished_  += 1;
+        available_ += result.available ? 1 : 0;
+        if (finished_ == expected_)
+        {
+            cv_.notify_all();
+        }
+    }
+
+    // Wait until all probes finished. Returns the number of available ones.
+    std::size_t wait()
+    {
+        auto lock = std::unique_lock<std::mutex>(mtx_);
+        cv_.wait(lock, [this] { return finished_ >= expected_; });
+        return available_;
+    }
+
+private:
+    std::mutex              mtx_;
+    std::condition_variable cv_;
+    std::size_t             expected_;
+    std::size_t             finished_;
+    std::size_t             available_;
+};
+
+// Submit @p count probes of @p port in batches of @p batch to an engine made
+// by @p factory. Prints probes per second until the last one finished.
+void run(char const* name, Factory const& factory, std::uint16_t port, std::size_t count, std::size_t batch)
+{
+    auto addr = resolve_address("127.0.0.1", AF_INET);
+    if (!addr)
+    {
+        abort("Failed to resolve loopback address");
+    }
+    set_port(addr.value(), port);
+
+    auto counter = Counter(count);
+    auto engine  = factory([&counter] (std::size_t, ProbeResult const& result)
+    {
+        counter.finish(result);
+    });
+
+    auto requests = std::vector<ProbeRequest>();
+    auto start    = Clock::now();
+    for (auto id = std::size_t(0); id < count; ++id)
+    {
+        requests.push_back(ProbeRequest{id, Protocol::Tcp, addr.value(), Clock::now() + seconds(5)});
+        if ((requests.size() == batch) || ((id + 1) == count))
+        {
+            engine->submit(requests);
+            requests.clear();
+        }
+    }
+    auto available = counter.wait();
+    auto elapsed   = duration_cast<microseconds>(Clock::now() - start).count();
+
+    std::cout << name << ": " << count << " probes, " << available << " available, "
+              << elapsed / 1000 << " ms, "
+              << static_cast<std::size_t>(static_cast<double>(count) * 1e6 / static_cast<double>(elapsed))
+              << " probes/s\n";
+}
+} // namespace
+
+// Usage: engine_bench [probes [batch]]
+// Defaults to 20000 probes submitted in batches of 1000.
+int main(int argc, char** argv)
+{
+    auto count = static_cast<std::size_t>((argc > 1) ? std::atol(argv[1]) : 20000);
+    auto batch = static_cast<std::size_t>((argc > 2) ? std::atol(argv[2]) : 1000);
+
+    raise_file_limit();
+
+    auto engines = std::vector<std::pair<char const*, Factory>>();
+    engines.emplace_back("epoll", [] (ProbeEngine::Completion completion)
+    {
+        return std::make_shared<TcpProbeEngine>(completion);
+    });
+    if (UringProbeEngine::is_supported())
+    {
+        engines.emplace_back("io_uring", [] (ProbeEngine::Completion completion)
+        {
+            return std::make_shared<UringProbeEngine>(completion);
+        });
+    }
+    else
+    {
+        std::cout << "io_uring: not supported by the kernel, skipped\n";
+    }
+
+    // Open port: Connects complete. Closed port: Connects are refused.
+    auto listener = Listener();
+    auto closed   = std::uint16_t(1);
+    for (auto const& [name, factory] : engines)
+    {
+        run(name, factory, listener.get_port(), count, batch);
+        run(name, factory, closed, count, batch);
+    }
+    return 0;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file      EventQueueBench.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Lock-free event queue compared to a mutex and condition variable.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <vector>
+#include <iostream>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <poll.h>
+#include "EventQueue.hpp"
+
+using namespace std::chrono;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// Outcome of a run: Time until the consumer got all events, time producers
+// spent pushing and the number of times the consumer woke up.
+struct Result
+{
+    Clock::duration elapsed;
+    Clock::duration pushing;
+    std::size_t     wakeups;
+};
+
+// Queue as it was before: Producers lock a mutex, append and notify.
+class MutexQueue
+{
+public:
+    void push(std::uint32_t event)
+    {
+        auto lock = std::lock_guard<std::mutex>(mtx_);
+        events_.push_back(event);
+        cv_.notify_one();
+    }
+
+    // Wait for events and swap them into @p events.
+    void wait(std::vector<std::uint32_t>& events)
+    {
+        auto lock = std::unique_lock<std::mutex>(mtx_);
+        cv_.wait(lock, [this] { return !events_.empty(); });
+        events.swap(events_);
+    }
+
+private:
+    std::mutex                 mtx_;
+    std::condition_variable    cv_;
+    std::vector<std::uint32_t> events_;
+};
+
+// Run @p producers threads, each calling @p push @p count times.
+// @p consume is run on the calling thread until all events arrived.
+template<typename Push, typename Consume>
+Result run(unsigned producers, std::size_t count, Push push, Consume consume)
+{
+    auto pushing = std::atomic<Clock::rep>(0);
+    auto threads = std::vector<std::thread>();
+    auto start   = Clock::now();
+
+    for (auto p = 0u; p < producers; ++p)
+    {
+        threads.emplace_back([p, count, &push, &pushing]
+        {
+            auto begin = Clock::now();
+            for (auto i = std::size_t(0); i < count; ++i)
+            {
+                push(static_cast<std::uint32_t>(p));
+            }
+            pushing += (Clock::now() - begin).count();
+        });
+    }
+
+    auto wakeups = consume(producers * count);
+    auto elapsed = Clock::now() - start;
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    return Result{elapsed, Clock::duration(pushing.load()), wakeups};
+}
+
+void print(char const* name, Result const& result, std::size_t events)
+{
+    auto ns = [events] (Clock::duration duration)
+    {
+        return static_cast<double>(duration_cast<nanoseconds>(duration).count()) / static_cast<double>(events);
+    };
+    std::cout << "    " << name << ": " << ns(result.elapsed) << " ns per event, "
+              << ns(result.pushing) << " ns producer time per push, "
+              << result.wakeups << " consumer wakeups\n";
+}
+} // namespace
+
+// Usage: event_queue_bench [events per producer [capacity]]
+// Defaults to 1000000 events. The queue holds all events of a run by
+// default, like the host table holds a slot per host.
+int main(int argc, char** argv)
+{
+    auto count    = static_cast<std::size_t>((argc > 1) ? std::atol(argv[1]) : 1000000);
+    auto capacity = static_cast<std::size_t>((argc > 2) ? std::atol(argv[2]) : 0);
+
+    for (auto producers : {1u, 2u, 4u, 8u})
+    {
+        auto events = producers * count;
+        std::cout << producers << " producers, " << events << " events:\n";
+
+        // Producers retry while the queue is full. The dirty flag of the
+        // host table keeps that from happening in the monitor.
+        auto queue    = EventQueue<std::uint32_t>(capacity ? capacity : events);
+        auto lockfree = run(producers, count, [&queue] (std::uint32_t event)
+        {
+            while (!queue.push(event))
+            {
+                std::this_thread::yield();
+            }
+        },
+        [&queue] (std::size_t expected)
+        {
+            auto received = std::size_t(0);
+            auto wakeups  = std::size_t(0);
+            while (received < expected)
+            {
+                auto pfd = pollfd{queue.get_fd(), POLLIN, 0};
+                ::poll(&pfd, 1, -1);
+                received += queue.drain([] (std::uint32_t) {});
+                wakeups  += 1;
+            }
+            return wakeups;
+        });
+        print("EventQueue", lockfree, events);
+
+        auto locked = MutexQueue();
+        auto mutex  = run(producers, count, [&locked] (std::uint32_t event)
+        {
+            locked.push(event);
+        },
+        [&locked] (std::size_t expected)
+        {
+            auto batch    = std::vector<std::uint32_t>();
+            auto received = std::size_t(0);
+            auto wakeups  = std::size_t(0);
+            while (received < expected)
+            {
+                locked.wait(batch);
+                received += batch.size();
+                wakeups  += 1;
+                batch.clear();
+            }
+            return wakeups;
+        });
+        print("Mutex/cv  ", mutex, events);
+    }
+    return 0;
+}
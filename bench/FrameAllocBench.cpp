@@ -0,0 +1,154 @@
+/**
+ * @file      FrameAllocBench.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Heap allocations per drawn ui frame.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <new>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include "Config.hpp"
+#include "GroupElement.hpp"
+#include "HostTable.hpp"
+#include "UserInterface.hpp"
+
+namespace
+{
+// Number of allocations through operator new. Allocations of curses
+// itself go through malloc and are not counted.
+std::atomic<std::size_t> allocations(0);
+
+std::size_t get_allocations()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// Usage: frame_alloc_bench [config [frames]]
+// Draws the ui of the config into /dev/null. Defaults to the example
+// config and 1000 frames. The terminal size is taken from LINES and COLUMNS.
+int main(int argc, char** argv)
+{
+    auto path   = std::string((argc > 1) ? argv[1] : "config/host_monitor_cli");
+    auto frames = static_cast<std::size_t>((argc > 2) ? std::atol(argv[2]) : 1000);
+
+    auto config = read_config_file(path);
+    auto count  = std::size_t(0);
+    for (auto const& grp : config.groups)
+    {
+        count += grp.hosts.size();
+    }
+
+    auto hosts     = HostTable(config.global.field_format, config.strings, count);
+    auto observers = std::vector<ProbeObserver::Pointer>();
+    auto groups    = std::vector<GroupElement::Pointer>();
+    for (auto const& grp : config.groups)
+    {
+        auto first = hosts.size();
+        for (auto const& host : grp.hosts)
+        {
+            observers.push_back(hosts.make_observer(hosts.add_host(host)));
+        }
+        groups.push_back(std::make_shared<GroupElement>(grp.name, hosts, first, hosts.size()));
+    }
+
+    // Curses writes to stdout, keep it for the results.
+    ::setenv("TERM", "xterm", 0);
+    ::setenv("LINES", "50", 0);
+    ::setenv("COLUMNS", "200", 0);
+    auto out  = ::dup(STDOUT_FILENO);
+    auto null = ::open("/dev/null", O_WRONLY);
+    ::dup2(null, STDOUT_FILENO);
+
+    auto full    = std::size_t(0);
+    auto partial = std::size_t(0);
+    auto results = std::size_t(0);
+    {
+        auto layout  = config.global.layout.value_or(Layout::List);
+        auto ui      = UserInterface(groups, hosts, config.global.field_format, layout);
+        auto changed = HostTable::Changed();
+        changed.reserve(count);
+
+        // Full redraws, as after scrolling and resizing
+        ui.draw();
+        auto before = get_allocations();
+        for (auto i = std::size_t(0); i < frames; ++i)
+        {
+            ui.draw();
+        }
+        full = get_allocations() - before;
+
+        // Frames redrawing changed hosts. Each frame all hosts flip their state.
+        for (auto i = std::size_t(0); i < frames; ++i)
+        {
+            auto result = ProbeResult{(i % 2) == 0, std::chrono::microseconds(1000 + i)};
+
+            before = get_allocations();
+            for (auto const& observer : observers)
+            {
+                observer->probe_finished(result);
+            }
+            results += get_allocations() - before;
+
+            before = get_allocations();
+            hosts.drain([&changed] (HostTable::Index host) { changed.push_back(host); });
+            ui.draw_changes(changed);
+            changed.clear();
+            partial += get_allocations() - before;
+        }
+    }
+
+    ::dup2(out, STDOUT_FILENO);
+    ::close(out);
+    ::close(null);
+
+    auto per = [frames] (std::size_t total)
+    {
+        return static_cast<double>(total) / static_cast<double>(frames);
+    };
+    auto memory = hosts.get_memory();
+    std::cout << "Host table of " << count << " hosts: " << memory << " bytes, "
+              << static_cast<double>(memory) / static_cast<double>(std::max(count, std::size_t(1)))
+              << " bytes per host\n";
+    std::cout << count << " hosts, " << frames << " frames of each kind:\n";
+    std::cout << "    Full draw:       " << per(full) << " allocations per frame\n";
+    std::cout << "    Changes drawn:   " << per(partial) << " allocations per frame\n";
+    std::cout << "    Probe results:   " << per(results) << " allocations per " << count << " results\n";
+    return 0;
+}
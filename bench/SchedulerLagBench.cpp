@@ -0,0 +1,197 @@
+/**
+ * @file      SchedulerLagBench.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Scheduling lag of the probe scheduler by number of hosts.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <sys/socket.h>
+#include "Address.hpp"
+#include "Constants.hpp"
+#include "Probe.hpp"
+#include "ProbeEngine.hpp"
+#include "ProbeScheduler.hpp"
+
+using namespace std::chrono;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// Answers each probe immediately. Records how late each probe started
+// compared to one interval after the previous probe of its host.
+class InstantEngine : public ProbeEngine
+{
+public:
+    InstantEngine(Completion completion, std::size_t hosts, Clock::duration interval)
+        : completion_(std::move(completion))
+        , interval_(interval)
+        , mtx_()
+        , last_(hosts)
+        , lags_()
+    {
+        lags_.reserve(hosts * 8);
+    }
+
+    virtual void submit(std::vector<ProbeRequest> const& requests) override
+    {
+        auto now = Clock::now();
+        {
+            auto lock = std::lock_guard<std::mutex>(mtx_);
+            for (auto const& request : requests)
+            {
+                auto& last = last_[request.id];
+                if (last != Clock::time_point())
+                {
+                    lags_.push_back(now - last - interval_);
+                }
+                last = now;
+            }
+        }
+
+        for (auto const& request : requests)
+        {
+            completion_(request.id, ProbeResult{true, microseconds(100)});
+        }
+    }
+
+    // Get lags of all probes so far.
+    std::vector<Clock::duration> get_lags()
+    {
+        auto lock = std::lock_guard<std::mutex>(mtx_);
+        return lags_;
+    }
+
+private:
+    Completion                     completion_;
+    Clock::duration                interval_;
+    std::mutex                     mtx_;
+    std::vector<Clock::time_point> last_;
+    std::vector<Clock::duration>   lags_;
+};
+
+// Nothing to observe, the engine measures.
+class NullObserver : public ProbeObserver
+{
+public:
+    virtual void probe_finished(ProbeResult const&) override
+    {
+    }
+};
+
+double to_ms(Clock::duration duration)
+{
+    return duration_cast<microseconds>(duration).count() / 1000.0;
+}
+
+// Probe @p hosts distinct hosts every second for @p runtime and print
+// the distribution of the scheduling lag.
+void run(std::size_t hosts, Clock::duration runtime)
+{
+    auto interval = seconds(1);
+    auto engine   = std::shared_ptr<InstantEngine>();
+
+    auto make_engines = [&engine, hosts, interval] (ProbeEngine::Completion completion)
+    {
+        engine = std::make_shared<InstantEngine>(completion, hosts, interval);
+        return ProbeScheduler::Engines(engine, engine);
+    };
+    auto lookup = [] (std::string const& fqhn, int family)
+    {
+        return resolve_address(fqhn, family);
+    };
+
+    auto scheduler = ProbeScheduler( probe_worker_count
+                                   , make_engines
+                                   , lookup
+                                   , ProbeConfirm{0, milliseconds(probe_confirm_space_ms)}
+                                   , ProbeLimits{0, 0, true}
+                                   );
+    auto observer = std::make_shared<NullObserver>();
+
+    for (auto i = std::size_t(0); i < hosts; ++i)
+    {
+        auto name   = "10." + std::to_string((i >> 16) & 0xff)
+                    + "."   + std::to_string((i >> 8) & 0xff)
+                    + "."   + std::to_string(i & 0xff);
+        auto target = ProbeTarget{ Protocol::Tcp
+                                 , Resolver::Name(name, AF_INET)
+                                 , 80
+                                 , milliseconds(probe_timeout_ms)
+                                 , milliseconds(probe_max_timeout_ms)
+                                 };
+        scheduler.add_probe(target, ProbeInterval{interval, interval, interval}, observer);
+    }
+
+    scheduler.start();
+    auto started = Clock::now();
+    while ((Clock::now() - started) < runtime)
+    {
+        std::this_thread::sleep_for(milliseconds(100));
+    }
+    scheduler.stop();
+
+    auto lags = engine->get_lags();
+    if (lags.empty())
+    {
+        std::cout << hosts << " hosts: no probe was repeated\n";
+        return;
+    }
+    std::sort(lags.begin(), lags.end());
+
+    auto sum = Clock::duration(0);
+    for (auto lag : lags)
+    {
+        sum += lag;
+    }
+    auto percentile = [&lags] (std::size_t p)
+    {
+        return lags[std::min(lags.size() - 1, lags.size() * p / 100)];
+    };
+
+    std::cout << hosts << " hosts, " << lags.size() << " probes: lag ms"
+              << " mean " << to_ms(sum / static_cast<long>(lags.size()))
+              << " p50 "  << to_ms(percentile(50))
+              << " p99 "  << to_ms(percentile(99))
+              << " max "  << to_ms(lags.back())
+              << "\n";
+}
+} // namespace
+
+// Usage: scheduler_lag_bench [seconds [hosts...]]
+// Defaults to 5 seconds with 1000, 10000 and 100000 hosts.
+int main(int argc, char** argv)
+{
+    auto runtime = seconds((argc > 1) ? std::atoi(argv[1]) : 5);
+    auto sizes   = std::vector<std::size_t>{1000, 10000, 100000};
+    if (argc > 2)
+    {
+        sizes.clear();
+        for (auto i = 2; i < argc; ++i)
+        {
+            sizes.push_back(static_cast<std::size_t>(std::atol(argv[i])));
+        }
+    }
+
+    for (auto hosts : sizes)
+    {
+        run(hosts, runtime);
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file      Address.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Socket address handling.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "Address.hpp"
+
+int Address::family() const
+{
+    return storage.ss_family;
+}
+
+sockaddr const* Address::get() const
+{
+    return reinterpret_cast<sockaddr const*>(&storage);
+}
+
+sockaddr* Address::get()
+{
+    return reinterpret_cast<sockaddr*>(&storage);
+}
+
+std::optional<Address> resolve_address(std::string const& fqhn, int family)
+{
+    auto hints = addrinfo();
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = family;
+    hints.ai_socktype = SOCK_STREAM;
+
+    auto info = static_cast<addrinfo*>(nullptr);
+    if (::getaddrinfo(fqhn.c_str(), nullptr, &hints, &info) != 0)
+    {
+        return {};
+    }
+
+    auto addr = Address();
+    std::memset(&addr.storage, 0, sizeof(addr.storage));
+    std::memcpy(&addr.storage, info->ai_addr, info->ai_addrlen);
+    addr.length = info->ai_addrlen;
+
+    ::freeaddrinfo(info);
+    return addr;
+}
+
+void set_port(Address& addr, std::uint16_t port)
+{
+    if (addr.family() == AF_INET6)
+    {
+        reinterpret_cast<sockaddr_in6*>(&addr.storage)->sin6_port = htons(port);
+    }
+    else if (addr.family() == AF_INET)
+    {
+        reinterpret_cast<sockaddr_in*>(&addr.storage)->sin_port = htons(port);
+    }
+}
+
+std::string address_to_string(Address const& addr)
+{
+    char buf[INET6_ADDRSTRLEN] = {};
+
+    if (addr.family() == AF_INET6)
+    {
+        auto in6 = reinterpret_cast<sockaddr_in6 const*>(&addr.storage);
+        ::inet_ntop(AF_INET6, &in6->sin6_addr, buf, sizeof(buf));
+    }
+    else if (addr.family() == AF_INET)
+    {
+        auto in = reinterpret_cast<sockaddr_in const*>(&addr.storage);
+        ::inet_ntop(AF_INET, &in->sin_addr, buf, sizeof(buf));
+    }
+    return std::string(buf);
+}
+
+Subnet get_subnet(Address const& addr, unsigned prefix)
+{
+    auto subnet = Subnet(addr.family(), {});
+    auto size   = 0u;
+
+    if (addr.family() == AF_INET6)
+    {
+        auto const& in6 = reinterpret_cast<sockaddr_in6 const*>(&addr.storage)->sin6_addr;
+        size = sizeof(in6_addr);
+        std::memcpy(subnet.second.data(), in6.s6_addr, size);
+    }
+    else if (addr.family() == AF_INET)
+    {
+        auto const& in4 = reinterpret_cast<sockaddr_in const*>(&addr.storage)->sin_addr;
+        size = sizeof(in_addr);
+        std::memcpy(subnet.second.data(), &in4, size);
+    }
+
+    // Clear all bits behind the prefix
+    for (auto i = 0u; i < size; ++i)
+    {
+        auto bits = (prefix > i * 8) ? (prefix - i * 8) : 0u;
+        if (bits < 8)
+        {
+            subnet.second[i] = static_cast<std::uint8_t>(subnet.second[i] & ~(0xFFu >> bits));
+        }
+    }
+    return subnet;
+}
+
+bool same_address(Address const& lhs, Address const& rhs)
+{
+    return same_address(lhs.storage, rhs);
+}
+
+bool same_address(sockaddr_storage const& lhs, Address const& rhs)
+{
+    if (lhs.ss_family != rhs.storage.ss_family)
+    {
+        return false;
+    }
+
+    if (lhs.ss_family == AF_INET6)
+    {
+        auto l = reinterpret_cast<sockaddr_in6 const*>(&lhs);
+        auto r = reinterpret_cast<sockaddr_in6 const*>(&rhs.storage);
+        return std::memcmp(&l->sin6_addr, &r->sin6_addr, sizeof(in6_addr)) == 0;
+    }
+
+    auto l = reinterpret_cast<sockaddr_in const*>(&lhs);
+    auto r = reinterpret_cast<sockaddr_in const*>(&rhs.storage);
+    return l->sin_addr.s_addr == r->sin_addr.s_addr;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file      Address.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Socket address handling.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef ADDRESS_HPP_201812271942
+#define ADDRESS_HPP_201812271942
+
+#include <array>
+#include <string>
+#include <utility>
+#include <optional>
+#include <cstdint>
+#include <sys/socket.h>
+
+// IPv4 or IPv6 socket address.
+struct Address
+{
+    sockaddr_storage storage;
+    socklen_t        length = 0;
+
+    // Get address family.
+    int family() const;
+
+    // Get pointer for use in socket calls.
+    sockaddr const* get() const;
+    sockaddr* get();
+};
+
+// Resolve @p fqhn into an address of @p family. AF_UNSPEC accepts any family.
+// In case the name can't be resolved, an empty optional is returned.
+std::optional<Address> resolve_address(std::string const& fqhn, int family);
+
+// Set port of @p addr.
+void set_port(Address& addr, std::uint16_t port);
+
+// Get numeric ip address of @p addr as string. The port is omitted.
+std::string address_to_string(Address const& addr);
+
+// Subnet of an address: Its family and the ip address with all
+// bits behind the prefix cleared. IPv4 addresses use the first 4 bytes.
+using Subnet = std::pair<int, std::array<std::uint8_t, 16>>;
+
+// Get subnet of @p addr with a prefix length of @p prefix. Doesn't allocate.
+Subnet get_subnet(Address const& addr, unsigned prefix);
+
+// Compare family and ip address of two addresses. Ports are ignored.
+bool same_address(Address const& lhs, Address const& rhs);
+bool same_address(sockaddr_storage const& lhs, Address const& rhs);
+
+#endif // ADDRESS_HPP_201812271942
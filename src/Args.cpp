@@ -24,12 +24,13 @@ void print_usage()
 {
     std::cout << "\n";
     std::cout << "Usage:\n";
-    std::cout << "    host_monitor_cli [-h] [-f <path>]\n";
+    std::cout << "    host_monitor_cli [-h] [-f <path>] [--stats]\n";
     std::cout << "\n";
     std::cout << "Options:\n";
     std::cout << "    -f <path>   User specified configuration file\n";
     std::cout << "    -h          Print this help\n";
     std::cout << "    -v          Print Version Information\n";
+    std::cout << "    --stats     Print memory used by the configuration and exit\n";
     std::cout << std::endl;
 }
 
@@ -91,6 +92,12 @@ std::map<std::string, std::string> read_args(int cargc, char **cargv)
             }
         }
 
+        // Examine --stats option
+        else if (*it == "--stats")
+        {
+            args["--stats"] = "";
+        }
+
         // Unknown option abort
         else
         {
@@ -13,13 +13,11 @@
 
 #include <fstream>
 #include <cstring>
-#include <host_monitor/Endpoint.hpp>
+#include <limits>
 #include "Util.hpp"
 #include "Constants.hpp"
 #include "Config.hpp"
 
-using namespace host_monitor;
-
 namespace
 {
 using LineNo      = unsigned;
@@ -94,6 +92,64 @@ std::string_view get_line_value(Line const& line, char const *marker)
     return content;
 }
 
+// Get number from a line associated with a marker. The number
+// must lie within [@p min, @p max].
+int get_line_number(Line const& line, char const *marker, int min, int max)
+{
+    auto value = string_to_int(get_line_value(line, marker));
+    if (!value || (value.value() < min) || (max < value.value()))
+    {
+        auto msg = std::string("Value is not a number in range: [");
+        msg += std::to_string(min) + ": " + std::to_string(max) + "]";
+        abort_parsing(line, msg);
+    }
+    return value.value();
+}
+
+// Get protocol from a line associated with a marker
+Protocol get_line_protocol(Line const& line, char const *marker)
+{
+    auto proto = string_to_protocol(get_line_value(line, marker));
+    if (proto == Protocol::Undef)
+    {
+        abort_parsing(line, "Protocol is neither ICMPV4, ICMPV6 nor TCP");
+    }
+    return proto;
+}
+
+// Get probe backend from a line associated with a marker
+Backend get_line_backend(Line const& line, char const *marker)
+{
+    auto backend = string_to_backend(get_line_value(line, marker));
+    if (backend == Backend::Undef)
+    {
+        abort_parsing(line, "Probe backend is neither EPOLL nor IO_URING");
+    }
+    return backend;
+}
+
+// Get layout from a line associated with a marker
+Layout get_line_layout(Line const& line, char const *marker)
+{
+    auto layout = string_to_layout(get_line_value(line, marker));
+    if (layout == Layout::Undef)
+    {
+        abort_parsing(line, "Layout is neither LIST, COLUMNS nor HEATMAP");
+    }
+    return layout;
+}
+
+// Get switch from a line associated with a marker. ON is true, OFF is false.
+bool get_line_switch(Line const& line, char const *marker)
+{
+    auto value = get_line_value(line, marker);
+    if ((value != "ON") && (value != "OFF"))
+    {
+        abort_parsing(line, "Value is neither ON nor OFF");
+    }
+    return value == "ON";
+}
+
 // Remove comments and trim the result
 std::string_view trim_and_remove_comment(std::string const& line)
 {
@@ -152,9 +208,11 @@ void load_config_file( std::string const& cfg_file_path
 void read_host_section( std::vector<Line>::const_iterator& line
                       , std::vector<Line>::const_iterator  end
                       , ConfigGroup&                       grp
+                      , StringArena&                       strings
                       )
 {
     auto section = ConfigHost();
+    auto has_protocol = false;
     auto begin = line;
     auto marker = get_line_marker(*begin);
 
@@ -165,6 +223,9 @@ void read_host_section( std::vector<Line>::const_iterator& line
         abort_parsing(*begin, msg);
     }
 
+    // Numbers are parsed right away, they must be positive
+    auto const max_number = std::numeric_limits<int>::max();
+
     // Given iterator seems legit, continue reading
     ++line;
     for (; line != end; ++line)
@@ -177,54 +238,88 @@ void read_host_section( std::vector<Line>::const_iterator& line
         // 5) Protocol
         // 6) Port
         // 7) Interval
-        // 8) End of host
+        // 8) Min. Interval
+        // 9) Max. Interval
+        // 10) Timeout
+        // 11) Max. Timeout
+        // 12) End of host
         marker = get_line_marker(*line);
 
         // 1) Read FQHN
         if (marker == cfg_marker_host_fqhn)
         {
             auto view = get_line_value(*line, cfg_marker_host_fqhn);
-            section.fqhn = std::move(std::string(view.begin(), view.end()));
+            section.fqhn = strings.intern(view);
         }
         // 2) Read Alias
         else if (marker == cfg_marker_host_alias)
         {
             auto view = get_line_value(*line, cfg_marker_host_alias);
-            section.alias = std::move(std::string(view.begin(), view.end()));
+            section.alias = strings.intern(view);
         }
         // 3) Read Role
         else if (marker == cfg_marker_host_role)
         {
             auto view = get_line_value(*line, cfg_marker_host_role);
-            section.role = std::move(std::string(view.begin(), view.end()));
+            section.role = strings.intern(view);
         }
         // 4) Read Device
         else if (marker == cfg_marker_host_device)
         {
             auto view = get_line_value(*line, cfg_marker_host_device);
-            section.device = std::move(std::string(view.begin(), view.end()));
+            section.device = strings.intern(view);
         }
         // 5) Read Protocol
         else if (marker == cfg_marker_host_protocol)
         {
-            auto view = get_line_value(*line, cfg_marker_host_protocol);
-            section.protocol = std::move(std::string(view.begin(), view.end()));
+            section.protocol = get_line_protocol(*line, cfg_marker_host_protocol);
+            has_protocol = true;
         }
         // 6) Read Port
         else if (marker == cfg_marker_host_port)
         {
-            auto view = get_line_value(*line, cfg_marker_host_port);
-            section.port = std::move(std::string(view.begin(), view.end()));
+            section.port = static_cast<std::uint16_t>(get_line_number(*line, cfg_marker_host_port, 1, 0xFFFF));
         }
         // 7) Read Interval
         else if (marker == cfg_marker_host_interval)
         {
-            auto view = get_line_value(*line, cfg_marker_host_interval);
-            section.interval = std::move(std::string(view.begin(), view.end()));
+            section.interval = std::chrono::seconds(get_line_number(*line, cfg_marker_host_interval, 1, max_number));
+        }
+        // 8) Read Min. Interval
+        else if (marker == cfg_marker_host_min_interval)
+        {
+            section.min_interval = std::chrono::seconds(get_line_number(*line, cfg_marker_host_min_interval, 1, max_number));
+        }
+        // 9) Read Max. Interval
+        else if (marker == cfg_marker_host_max_interval)
+        {
+            section.max_interval = std::chrono::seconds(get_line_number(*line, cfg_marker_host_max_interval, 1, max_number));
         }
-        // 8) Read section end. Assign read section and return.
+        // 10) Read Timeout
+        else if (marker == cfg_marker_host_timeout)
+        {
+            section.timeout = std::chrono::milliseconds(get_line_number(*line, cfg_marker_host_timeout, 1, max_number));
+        }
+        // 11) Read Max. Timeout
+        else if (marker == cfg_marker_host_max_timeout)
+        {
+            section.max_timeout = std::chrono::milliseconds(get_line_number(*line, cfg_marker_host_max_timeout, 1, max_number));
+        }
+        // 12) Read section end. Assign read section and return.
         else if(marker == cfg_marker_host_section_end)
         {
+            if (section.fqhn == StringArena::empty)
+            {
+                abort_parsing(*begin, "Host is missing the manditory field: FQHN");
+            }
+            if (section.interval.count() == 0)
+            {
+                abort_parsing(*begin, "Host is missing the manditory field: INTERVAL");
+            }
+            if (has_protocol == false)
+            {
+                abort_parsing(*begin, "Host is missing the manditory field: PROTOCOL");
+            }
             grp.hosts.push_back(std::move(section));
             return;
         }
@@ -275,7 +370,7 @@ void read_group_section( std::vector<Line>::const_iterator& line
         // 2) Read host section.
         else if(marker == cfg_marker_host_section_begin)
         {
-            read_host_section(line, end, section);
+            read_host_section(line, end, section, cfg.strings);
         }
         // 3) Read section end. Assign read section and return.
         else if(marker == cfg_marker_group_section_end)
@@ -311,13 +406,25 @@ void read_config_section( std::vector<Line>::const_iterator& line
         abort_parsing(*begin, msg);
     }
 
+    // Numbers are parsed right away, they must not be negative
+    auto const max_number = std::numeric_limits<int>::max();
+
     // Given iterator seems legit, continue reading
     ++line;
     for (; line != end; ++line)
     {
         // Valid marker are:
         // 1) Field order
-        // 2) End of config
+        // 2) Probe backend
+        // 3) Hosts file
+        // 4) Confirm retries
+        // 5) Confirm spacing
+        // 6) Rate limit
+        // 7) Subnet rate limit
+        // 8) Phase spread
+        // 9) Frame rate
+        // 10) Layout
+        // 11) End of config
         marker = get_line_marker(*line);
 
         // 1) Read field order
@@ -326,8 +433,53 @@ void read_config_section( std::vector<Line>::const_iterator& line
             auto view = get_line_value(*line, cfg_marker_config_field_order);
             section.field_order = std::move(std::string(view.begin(), view.end()));
         }
-
-        // 2) Read section end. Assign read section and return.
+        // 2) Read probe backend
+        else if (marker == cfg_marker_config_probe_backend)
+        {
+            section.probe_backend = get_line_backend(*line, cfg_marker_config_probe_backend);
+        }
+        // 3) Read hosts file
+        else if (marker == cfg_marker_config_hosts_file)
+        {
+            auto view = get_line_value(*line, cfg_marker_config_hosts_file);
+            section.hosts_file = std::move(std::string(view.begin(), view.end()));
+        }
+        // 4) Read confirm retries
+        else if (marker == cfg_marker_config_confirm_count)
+        {
+            section.confirm_retries = static_cast<unsigned>(get_line_number(*line, cfg_marker_config_confirm_count, 0, max_number));
+        }
+        // 5) Read confirm spacing
+        else if (marker == cfg_marker_config_confirm_space)
+        {
+            section.confirm_spacing = std::chrono::milliseconds(get_line_number(*line, cfg_marker_config_confirm_space, 1, max_number));
+        }
+        // 6) Read rate limit
+        else if (marker == cfg_marker_config_rate_limit)
+        {
+            section.rate_limit = static_cast<unsigned>(get_line_number(*line, cfg_marker_config_rate_limit, 0, max_number));
+        }
+        // 7) Read subnet rate limit
+        else if (marker == cfg_marker_config_subnet_limit)
+        {
+            section.subnet_rate_limit = static_cast<unsigned>(get_line_number(*line, cfg_marker_config_subnet_limit, 0, max_number));
+        }
+        // 8) Read phase spread
+        else if (marker == cfg_marker_config_phase_spread)
+        {
+            section.phase_spread = get_line_switch(*line, cfg_marker_config_phase_spread);
+        }
+        // 9) Read frame rate
+        else if (marker == cfg_marker_config_frame_rate)
+        {
+            section.frame_rate = static_cast<unsigned>(get_line_number(*line, cfg_marker_config_frame_rate, 1, max_number));
+        }
+        // 10) Read layout
+        else if (marker == cfg_marker_config_layout)
+        {
+            section.layout = get_line_layout(*line, cfg_marker_config_layout);
+        }
+        // 11) Read section end. Assign read section and return.
         else if(marker == cfg_marker_config_section_end)
         {
             cfg.global = std::move(section);
@@ -374,73 +526,30 @@ void read_config(std::vector<Line> const& cfg_file_content, Config& cfg)
     }
 }
 
-// Verify host section in config structure
+// Verify host section in config structure. Values and mandatory
+// fields were checked while reading, check how they relate.
 void verify_host_section(ConfigHost const& host)
 {
-    // Check if FQHN is set. Manditory.
-    if (host.fqhn.empty())
+    // Verify optional interval range. INTERVAL must lie within it.
+    if ((host.min_interval.count() != 0) && (host.interval < host.min_interval))
     {
-        abort("A host is missing the manditory field: FQHN");
+        abort("A hosts min. interval is not in range: [1: INTERVAL]");
     }
-
-    // Check if INTERVAL is set. Manditory.
-    if (host.interval.empty())
+    if ((host.max_interval.count() != 0) && (host.max_interval < host.interval))
     {
-        abort("A host is missing the manditory field: INTERVAL");
+        abort("A hosts max. interval is less than its interval");
     }
 
-    // Verify that interval is a positive number.
-    auto interval = string_to_int(host.interval);
-    if (interval)
+    // Verify optional timeouts. Both are given in milliseconds.
+    if ((host.timeout.count() != 0) && (host.max_timeout.count() != 0) && (host.max_timeout < host.timeout))
     {
-        auto val = interval.value();
-        if (val <= 0)
-        {
-            abort("A hosts inverval is less or equal zero");
-        }
-    }
-    else
-    {
-        abort("A hosts interval is not a number");
+        abort("A hosts max. timeout is less than its timeout");
     }
 
-    // Check if PROTOCOL is set. Manditory.
-    if (host.protocol.empty())
+    // Check if PORT is set. Manditory if PROTOCOL is TCP.
+    if ((host.protocol == Protocol::Tcp) && (host.port == 0))
     {
-        abort("A host is missing the manditory field: PROTOCOL");
-    }
-
-    // Verify given Protocol
-    auto proto = string_to_protocol(host.protocol);
-    if (proto)
-    {
-        // In case of TCP, a valid port must be set
-        if (proto.value() == Endpoint::Protocol::TCP)
-        {
-            // Check if PORT is set. Manditory if PROTOCOL is TCP.
-            if (!host.port)
-            {
-                abort("A host is missing the manditory field: PORT. Only for TCP hosts");
-            }
-
-            // Verfiy that given port is a valid port.
-            auto port = string_to_int(host.port.value());
-            if (port)
-            {
-                if ((port <= 0) || (0xFFFF < port))
-                {
-                    abort("A hosts port is not in range: [1: 65535]");
-                }
-            }
-            else
-            {
-                abort("A hosts port is not a number");
-            }
-        }
-    }
-    else
-    {
-        abort("A hosts protocol is neither ICMPV4, ICMPV6 nor TCP.");
+        abort("A host is missing the manditory field: PORT. Only for TCP hosts");
     }
 }
 
@@ -565,18 +674,26 @@ unsigned get_field_length_ui_fields(Field field)
 {
     switch(field)
     {
-        case Field::Fqhn:     return std::strlen(ui_header_fqhn);
-        case Field::Alias:    return std::strlen(ui_header_alias);
-        case Field::Role:     return std::strlen(ui_header_role);
-        case Field::Device:   return std::strlen(ui_header_device);
-        case Field::Interval: return std::strlen(ui_header_interval);
-        case Field::Protocol: return std::strlen(ui_header_protocol);
-        default:              return 0;
+        case Field::Fqhn:      return std::strlen(ui_header_fqhn);
+        case Field::Alias:     return std::strlen(ui_header_alias);
+        case Field::Role:      return std::strlen(ui_header_role);
+        case Field::Device:    return std::strlen(ui_header_device);
+        case Field::Interval:  return std::strlen(ui_header_interval);
+        case Field::Protocol:  return std::strlen(ui_header_protocol);
+        case Field::RttLast:   return std::strlen(ui_header_rtt_last);
+        case Field::RttMin:    return std::strlen(ui_header_rtt_min);
+        case Field::RttAvg:    return std::strlen(ui_header_rtt_avg);
+        case Field::RttMax:    return std::strlen(ui_header_rtt_max);
+        case Field::RttJitter: return std::strlen(ui_header_rtt_jitter);
+        case Field::RttP50:    return std::strlen(ui_header_rtt_p50);
+        case Field::RttP95:    return std::strlen(ui_header_rtt_p95);
+        case Field::RttP99:    return std::strlen(ui_header_rtt_p99);
+        default:               return 0;
     }
 }
 
 // Get length of the loaded ui fields
-unsigned get_field_length_host(ConfigHost const& host, Field field)
+unsigned get_field_length_host(ConfigHost const& host, StringArena const& strings, Field field)
 {
     auto result = 0u;
 
@@ -585,16 +702,16 @@ unsigned get_field_length_host(ConfigHost const& host, Field field)
         case Field::Undef:
             break;
         case Field::Fqhn:
-            result = static_cast<unsigned>(host.fqhn.size());
+            result = static_cast<unsigned>(strings.get(host.fqhn).size());
             break;
         case Field::Alias:
-            result = static_cast<unsigned>(host.alias.value_or("").size());
+            result = static_cast<unsigned>(strings.get(host.alias).size());
             break;
         case Field::Role:
-            result = static_cast<unsigned>(host.role.value_or("").size());
+            result = static_cast<unsigned>(strings.get(host.role).size());
             break;
         case Field::Device:
-            result = static_cast<unsigned>(host.device.value_or("").size());
+            result = static_cast<unsigned>(strings.get(host.device).size());
             break;
         case Field::Interval:
             result = static_cast<unsigned>(make_interval_string(host.interval).size());
@@ -602,6 +719,16 @@ unsigned get_field_length_host(ConfigHost const& host, Field field)
         case Field::Protocol:
             result = static_cast<unsigned>(make_proto_port_string(host.protocol, host.port).size());
             break;
+        case Field::RttLast:
+        case Field::RttMin:
+        case Field::RttAvg:
+        case Field::RttMax:
+        case Field::RttJitter:
+        case Field::RttP50:
+        case Field::RttP95:
+        case Field::RttP99:
+            result = ui_rtt_width;
+            break;
     }
 
     return result;
@@ -609,6 +736,7 @@ unsigned get_field_length_host(ConfigHost const& host, Field field)
 
 // Get minimum length of a given Field to display it properly.
 void get_field_length( std::vector<ConfigGroup> const& groups
+                     , StringArena const&              strings
                      , Field const&                    field
                      , ConfigGlobal::FieldLen&         field_len
                      )
@@ -621,7 +749,7 @@ void get_field_length( std::vector<ConfigGroup> const& groups
     {
         for (auto const& host: grp.hosts)
         {
-            field_len = std::max(field_len, get_field_length_host(host, field));
+            field_len = std::max(field_len, get_field_length_host(host, strings, field));
         }
     }
 }
@@ -635,7 +763,7 @@ void generate_field_format(Config& cfg)
     // Get the max length from field values.
     for (auto& [type, length] : fmt)
     {
-        get_field_length(cfg.groups, type, length);
+        get_field_length(cfg.groups, cfg.strings, type, length);
     }
 
     cfg.global.field_format = std::move(fmt);
@@ -667,13 +795,21 @@ std::string field_to_string(Field field)
 {
     switch(field)
     {
-        case Field::Fqhn:     return "FQHN";
-        case Field::Alias:    return "ALIAS";
-        case Field::Role:     return "ROLE";
-        case Field::Device:   return "DEVICE";
-        case Field::Protocol: return "PROTOCOL";
-        case Field::Interval: return "INTERVAL";
-        default:              return "UNDEF";
+        case Field::Fqhn:      return "FQHN";
+        case Field::Alias:     return "ALIAS";
+        case Field::Role:      return "ROLE";
+        case Field::Device:    return "DEVICE";
+        case Field::Protocol:  return "PROTOCOL";
+        case Field::Interval:  return "INTERVAL";
+        case Field::RttLast:   return "RTT_LAST";
+        case Field::RttMin:    return "RTT_MIN";
+        case Field::RttAvg:    return "RTT_AVG";
+        case Field::RttMax:    return "RTT_MAX";
+        case Field::RttJitter: return "RTT_JITTER";
+        case Field::RttP50:    return "RTT_P50";
+        case Field::RttP95:    return "RTT_P95";
+        case Field::RttP99:    return "RTT_P99";
+        default:               return "UNDEF";
     }
 }
 
@@ -703,60 +839,248 @@ Field string_to_field(std::string_view const& str)
     {
         return Field::Interval;
     }
+    if (str == "RTT_LAST")
+    {
+        return Field::RttLast;
+    }
+    if (str == "RTT_MIN")
+    {
+        return Field::RttMin;
+    }
+    if (str == "RTT_AVG")
+    {
+        return Field::RttAvg;
+    }
+    if (str == "RTT_MAX")
+    {
+        return Field::RttMax;
+    }
+    if (str == "RTT_JITTER")
+    {
+        return Field::RttJitter;
+    }
+    if (str == "RTT_P50")
+    {
+        return Field::RttP50;
+    }
+    if (str == "RTT_P95")
+    {
+        return Field::RttP95;
+    }
+    if (str == "RTT_P99")
+    {
+        return Field::RttP99;
+    }
     return Field::Undef;
 }
 
+std::string backend_to_string(Backend backend)
+{
+    switch(backend)
+    {
+        case Backend::Epoll:   return "EPOLL";
+        case Backend::IoUring: return "IO_URING";
+        default:               return "UNDEF";
+    }
+}
 
-// Config Streaming operators
-std::ostream& operator << (std::ostream& ost, Config const& cfg)
+Backend string_to_backend(std::string_view const& str)
 {
-    ost << "Config[global='" << cfg.global;
-    ost << "', groups=[";
+    if (str == "EPOLL")
+    {
+        return Backend::Epoll;
+    }
+    if (str == "IO_URING")
+    {
+        return Backend::IoUring;
+    }
+    return Backend::Undef;
+}
 
-    for (auto it = cfg.groups.begin(); it != cfg.groups.end(); ++it)
+std::string protocol_to_string(Protocol protocol)
+{
+    switch(protocol)
     {
-        ost << *it << ", ";
+        case Protocol::IcmpV4: return "ICMPV4";
+        case Protocol::IcmpV6: return "ICMPV6";
+        case Protocol::Tcp:    return "TCP";
+        default:               return "UNDEF";
     }
+}
 
-    ost << "]]";
-    return ost;
+Protocol string_to_protocol(std::string_view const& str)
+{
+    if (str == "ICMPV4")
+    {
+        return Protocol::IcmpV4;
+    }
+    if (str == "ICMPV6")
+    {
+        return Protocol::IcmpV6;
+    }
+    if (str == "TCP")
+    {
+        return Protocol::Tcp;
+    }
+    return Protocol::Undef;
 }
 
-std::ostream& operator << (std::ostream& ost, ConfigGlobal const& cfg)
+std::string layout_to_string(Layout layout)
 {
-    ost << "ConfigGlobal[field_order='" << cfg.field_order;
-    ost << "', field_format=[";
-    for (auto const& [field, len] : cfg.field_format)
+    switch(layout)
     {
-        ost << "[" << field_to_string(field) << ", " << len << "], ";
+        case Layout::List:    return "LIST";
+        case Layout::Columns: return "COLUMNS";
+        case Layout::Heatmap: return "HEATMAP";
+        default:              return "UNDEF";
     }
-    ost << "]]";
-    return ost;
 }
 
-std::ostream& operator << (std::ostream& ost, ConfigGroup const& cfg)
+Layout string_to_layout(std::string_view const& str)
+{
+    if (str == "LIST")
+    {
+        return Layout::List;
+    }
+    if (str == "COLUMNS")
+    {
+        return Layout::Columns;
+    }
+    if (str == "HEATMAP")
+    {
+        return Layout::Heatmap;
+    }
+    return Layout::Undef;
+}
+
+
+namespace
+{
+// Memory of @p str if kept in a std::string of its own. Short strings
+// are stored inside the std::string, longer ones are allocated.
+std::size_t get_string_memory(std::string_view const& str)
+{
+    return sizeof(std::string) + ((str.size() > std::string().capacity()) ? (str.size() + 1) : 0);
+}
+
+// Convert @p value with @p convert. An unset value is empty.
+template<typename T, typename Convert>
+std::string optional_to_string(std::optional<T> const& value, Convert convert)
+{
+    return value ? convert(value.value()) : std::string();
+}
+
+std::string number_to_string(unsigned value)
+{
+    return std::to_string(value);
+}
+
+std::string duration_to_string(std::chrono::milliseconds value)
+{
+    return std::to_string(value.count());
+}
+
+std::string switch_to_string(bool value)
+{
+    return value ? "ON" : "OFF";
+}
+
+std::ostream& print_group(std::ostream& ost, ConfigGroup const& cfg, StringArena const& strings)
 {
     ost << "ConfigGroup[name='" << cfg.name.value_or("");
     ost << "', hosts=[";
 
-    for (auto it = cfg.hosts.begin(); it != cfg.hosts.end(); ++it)
+    for (auto const& host : cfg.hosts)
     {
-        ost << *it << ", ";
+        ost << "ConfigHost[fqhn='" << strings.get(host.fqhn);
+        ost << "', alias='" << strings.get(host.alias);
+        ost << "', role='" << strings.get(host.role);
+        ost << "', device='" << strings.get(host.device);
+        ost << "', protocol='" << protocol_to_string(host.protocol);
+        ost << "', port='" << host.port;
+        ost << "', interval='" << host.interval.count();
+        ost << "', min_interval='" << host.min_interval.count();
+        ost << "', max_interval='" << host.max_interval.count();
+        ost << "', timeout='" << host.timeout.count();
+        ost << "', max_timeout='" << host.max_timeout.count();
+        ost << "'], ";
     }
     ost << "]]";
 
     return ost;
 }
+} // anon namespace
+
+void print_config_stats(std::ostream& ost, Config const& cfg)
+{
+    auto hosts    = std::size_t(0);
+    auto separate = std::size_t(0);
+
+    // Computed, not measured: Previously each of the 11 fields was a
+    // std::string, optional fields a std::optional<std::string>. Protocols
+    // and numbers are short enough to be stored inside the std::string.
+    for (auto const& grp : cfg.groups)
+    {
+        for (auto const& host : grp.hosts)
+        {
+            auto optional = { host.alias, host.role, host.device };
+
+            separate += get_string_memory(cfg.strings.get(host.fqhn));
+            separate += 2 * sizeof(std::string);
+            for (auto id : optional)
+            {
+                separate += sizeof(std::optional<std::string>) - sizeof(std::string);
+                separate += get_string_memory(cfg.strings.get(id));
+            }
+            separate += 5 * sizeof(std::optional<std::string>);
+        }
+        hosts += grp.hosts.size();
+    }
+
+    auto records = hosts * sizeof(ConfigHost);
+    auto arena   = cfg.strings.get_memory();
+
+    ost << "Config memory of " << hosts << " hosts:\n";
+    ost << "    Distinct strings: " << cfg.strings.size() << "\n";
+    ost << "    Host records:     " << records << " bytes\n";
+    ost << "    String arena:     " << arena << " bytes\n";
+    ost << "    Total:            " << records + arena << " bytes\n";
+    ost << "    Separate strings: " << separate << " bytes (computed for one std::string per field, not RSS)\n";
+    ost << std::flush;
+}
+
+// Config Streaming operators
+std::ostream& operator << (std::ostream& ost, Config const& cfg)
+{
+    ost << "Config[global='" << cfg.global;
+    ost << "', groups=[";
+
+    for (auto const& grp : cfg.groups)
+    {
+        print_group(ost, grp, cfg.strings) << ", ";
+    }
+
+    ost << "]]";
+    return ost;
+}
 
-std::ostream& operator << (std::ostream& ost, ConfigHost const& cfg)
+std::ostream& operator << (std::ostream& ost, ConfigGlobal const& cfg)
 {
-    ost << "ConfigHost[fqhn='" << cfg.fqhn;
-    ost << "', alias='" << cfg.alias.value_or("");
-    ost << "', role='" << cfg.role.value_or("");
-    ost << "', device='" << cfg.device.value_or("");
-    ost << "', protocol='" << cfg.protocol;
-    ost << "', port='" << cfg.port.value_or("");
-    ost << "', interval='" << cfg.interval;
+    ost << "ConfigGlobal[field_order='" << cfg.field_order;
+    ost << "', field_format=[";
+    for (auto const& [field, len] : cfg.field_format)
+    {
+        ost << "[" << field_to_string(field) << ", " << len << "], ";
+    }
+    ost << "], probe_backend='" << optional_to_string(cfg.probe_backend, backend_to_string);
+    ost << "', hosts_file='" << cfg.hosts_file.value_or("");
+    ost << "', confirm_retries='" << optional_to_string(cfg.confirm_retries, number_to_string);
+    ost << "', confirm_spacing='" << optional_to_string(cfg.confirm_spacing, duration_to_string);
+    ost << "', rate_limit='" << optional_to_string(cfg.rate_limit, number_to_string);
+    ost << "', subnet_rate_limit='" << optional_to_string(cfg.subnet_rate_limit, number_to_string);
+    ost << "', phase_spread='" << optional_to_string(cfg.phase_spread, switch_to_string);
+    ost << "', frame_rate='" << optional_to_string(cfg.frame_rate, number_to_string);
+    ost << "', layout='" << optional_to_string(cfg.layout, layout_to_string);
     ost << "']";
     return ost;
 }
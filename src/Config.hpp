@@ -18,7 +18,9 @@
 #include <string>
 #include <optional>
 #include <iostream>
+#include <chrono>
 #include <cstdint>
+#include "StringArena.hpp"
 
 // UI Field enum and some conversion functions.
 enum class Field
@@ -29,22 +31,73 @@ enum class Field
     Role,
     Device,
     Protocol,
-    Interval
+    Interval,
+    RttLast,
+    RttMin,
+    RttAvg,
+    RttMax,
+    RttJitter,
+    RttP50,
+    RttP95,
+    RttP99
 };
 
 std::string field_to_string(Field field);
 Field string_to_field(std::string_view const& str);
 
-// Configuration Objects
+// Probe Backend enum and some conversion functions.
+enum class Backend
+{
+    Undef = 0,
+    Epoll,
+    IoUring
+};
+
+std::string backend_to_string(Backend backend);
+Backend string_to_backend(std::string_view const& str);
+
+// Probe Protocol enum and some conversion functions.
+enum class Protocol
+{
+    Undef = 0,
+    IcmpV4,
+    IcmpV6,
+    Tcp
+};
+
+std::string protocol_to_string(Protocol protocol);
+Protocol string_to_protocol(std::string_view const& str);
+
+// Ui Layout enum and some conversion functions.
+enum class Layout
+{
+    Undef = 0,
+    List,
+    Columns,
+    Heatmap
+};
+
+std::string layout_to_string(Layout layout);
+Layout string_to_layout(std::string_view const& str);
+
+// Configuration Objects. Values are parsed once while reading. Host
+// text is interned into the arena of the config, unset optional text is
+// the empty string. Unset optional numbers are zero.
 struct ConfigHost
 {
-    std::string                fqhn;
-    std::string                protocol;
-    std::string                interval;
-    std::optional<std::string> alias;
-    std::optional<std::string> role;
-    std::optional<std::string> device;
-    std::optional<std::string> port;
+    using Text = StringArena::Id;
+
+    Text                             fqhn;
+    Text                             alias;
+    Text                             role;
+    Text                             device;
+    Protocol                         protocol;
+    std::uint16_t                    port;
+    std::chrono::seconds             interval;
+    std::chrono::seconds             min_interval;
+    std::chrono::seconds             max_interval;
+    std::chrono::milliseconds        timeout;
+    std::chrono::milliseconds        max_timeout;
 };
 
 struct ConfigGroup
@@ -58,22 +111,33 @@ struct ConfigGlobal
     using FieldLen = unsigned;
     using FieldFmt = std::pair<Field, FieldLen>;
 
-    std::string           field_order;
-    std::vector<FieldFmt> field_format;
+    std::string                              field_order;
+    std::vector<FieldFmt>                    field_format;
+    std::optional<Backend>                   probe_backend;
+    std::optional<std::string>               hosts_file;
+    std::optional<unsigned>                  confirm_retries;
+    std::optional<std::chrono::milliseconds> confirm_spacing;
+    std::optional<unsigned>                  rate_limit;
+    std::optional<unsigned>                  subnet_rate_limit;
+    std::optional<bool>                      phase_spread;
+    std::optional<unsigned>                  frame_rate;
+    std::optional<Layout>                    layout;
 };
 
 struct Config
 {
     ConfigGlobal             global;
     std::vector<ConfigGroup> groups;
+    StringArena              strings;
 };
 
 // Read configuration from file.
 Config read_config_file(std::string const& path);
 
+// Print memory used by the hosts of @p cfg.
+void print_config_stats(std::ostream& ost, Config const& cfg);
+
 std::ostream& operator << (std::ostream& ost, Config const& cfg);
 std::ostream& operator << (std::ostream& ost, ConfigGlobal const& cfg);
-std::ostream& operator << (std::ostream& ost, ConfigGroup const& cfg);
-std::ostream& operator << (std::ostream& ost, ConfigHost const& cfg);
 
 #endif // CONFIG_HPP_201804081223
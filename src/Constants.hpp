@@ -23,6 +23,15 @@ char const * const cfg_default_config_file         = ".host_monitor_cli";
 char const * const cfg_marker_config_section_begin = "BEGIN_CONFIG";
 char const * const cfg_marker_config_section_end   = "END_CONFIG";
 char const * const cfg_marker_config_field_order   = "FIELD_ORDER:";
+char const * const cfg_marker_config_probe_backend = "PROBE_BACKEND:";
+char const * const cfg_marker_config_hosts_file    = "HOSTS_FILE:";
+char const * const cfg_marker_config_confirm_count = "CONFIRM_RETRIES:";
+char const * const cfg_marker_config_confirm_space = "CONFIRM_SPACING:";
+char const * const cfg_marker_config_rate_limit    = "RATE_LIMIT:";
+char const * const cfg_marker_config_subnet_limit  = "SUBNET_RATE_LIMIT:";
+char const * const cfg_marker_config_phase_spread  = "PHASE_SPREAD:";
+char const * const cfg_marker_config_frame_rate    = "FRAME_RATE:";
+char const * const cfg_marker_config_layout        = "LAYOUT:";
 char const * const cfg_marker_group_section_begin  = "BEGIN_GROUP";
 char const * const cfg_marker_group_section_end    = "END_GROUP";
 char const * const cfg_marker_group_name           = "NAME:";
@@ -35,6 +44,32 @@ char const * const cfg_marker_host_device          = "DEVICE:";
 char const * const cfg_marker_host_protocol        = "PROTOCOL:";
 char const * const cfg_marker_host_port            = "PORT:";
 char const * const cfg_marker_host_interval        = "INTERVAL:";
+char const * const cfg_marker_host_min_interval    = "MIN_INTERVAL:";
+char const * const cfg_marker_host_max_interval    = "MAX_INTERVAL:";
+char const * const cfg_marker_host_timeout         = "TIMEOUT:";
+char const * const cfg_marker_host_max_timeout     = "MAX_TIMEOUT:";
+
+// Probe Constants
+unsigned const probe_worker_count      = 4;
+unsigned const probe_tick_ms           = 10;
+unsigned const probe_timeout_ms        = 1000;
+unsigned const probe_min_timeout_ms    = 200;
+unsigned const probe_max_timeout_ms    = 5000;
+unsigned const probe_epoll_batch       = 256;
+unsigned const probe_connect_batch     = 1024;
+unsigned const probe_icmp_batch        = 64;
+unsigned const probe_icmp_start_batch  = 1024;
+unsigned const probe_icmp_buffer_size  = 4 * 1024 * 1024;
+unsigned const probe_uring_entries     = 4096;
+unsigned const probe_uring_start_batch = 256;
+unsigned const probe_uring_receives    = 1024;
+unsigned const probe_dns_threads       = 8;
+unsigned const probe_dns_ttl_s         = 300;
+unsigned const probe_dns_retry_s       = 30;
+unsigned const probe_confirm_retries   = 2;
+unsigned const probe_confirm_space_ms  = 500;
+unsigned const probe_subnet_prefix_v4  = 24;
+unsigned const probe_subnet_prefix_v6  = 64;
 
 // UI Constants
 unsigned const ui_border_width         = 1;
@@ -51,9 +86,28 @@ char const     ui_header_role[]        = "Role:";
 char const     ui_header_device[]      = "Device:";
 char const     ui_header_protocol[]    = "Protocol:";
 char const     ui_header_interval[]    = "Interval:";
+char const     ui_header_rtt_last[]    = "Last:";
+char const     ui_header_rtt_min[]     = "Min:";
+char const     ui_header_rtt_avg[]     = "Avg:";
+char const     ui_header_rtt_max[]     = "Max:";
+char const     ui_header_rtt_jitter[]  = "Jitter:";
+char const     ui_header_rtt_p50[]     = "P50:";
+char const     ui_header_rtt_p95[]     = "P95:";
+char const     ui_header_rtt_p99[]     = "P99:";
 char const     ui_header_status[]      = "Status:";
 unsigned const ui_footer_height        = 2;
 char const     ui_footer_quit[]        = "Press 'ctrl + c' to quit.";
-unsigned const ui_observer_elem_height = 1;
+char const     ui_footer_scroll[]      = "Scroll: Up, Down, PgUp, PgDn, Home, End.";
+char const     ui_footer_frames[]      = "Frames: ";
+char const     ui_footer_coalesced[]   = "Coalesced: ";
+char const     ui_footer_layout[]      = "Layout: 'l'.";
+char const     ui_header_heatmap[]     = "Hosts by group. Green: available, Red: unavailable.";
+char const     ui_heatmap_cell[]       = " ";
+unsigned const ui_column_gap           = 3;
+unsigned const ui_rtt_width            = 9;
+char const     ui_rtt_unit[]           = "ms";
+char const     ui_rtt_none[]           = "-";
+unsigned const ui_frame_rate           = 20;
+unsigned const ui_resize_delay_ms      = 100;
 
 #endif // CONSTANTS_HPP_201804081223
@@ -0,0 +1,170 @@
+/**
+ * @file      EventQueue.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Bounded lock-free event queue with eventfd wakeup.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef EVENTQUEUE_HPP_201812311720
+#define EVENTQUEUE_HPP_201812311720
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sys/eventfd.h>
+#include "FileDescriptor.hpp"
+#include "Util.hpp"
+
+// Bounded multi-producer/single-consumer ring of small trivially copyable
+// events. Each slot carries a sequence number telling producers and the
+// consumer whose turn it is, neither side ever takes a lock. The consumer
+// is woken through an eventfd, signaled once until it drains the queue.
+template<typename T>
+class EventQueue
+{
+public:
+    // Constructor: The queue holds at least @p capacity events.
+    explicit EventQueue(std::size_t capacity)
+        : slots_(round_capacity(capacity))
+        , mask_(slots_.size() - 1)
+        , tail_(0)
+        , head_(0)
+        , signaled_(false)
+        , event_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+        if (!event_.is_valid())
+        {
+            abort("Failed to setup event queue");
+        }
+
+        for (auto i = std::size_t(0); i < slots_.size(); ++i)
+        {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Disable Copy and Move Semantics, producers refer to the queue.
+    EventQueue(EventQueue const& other) = delete;
+    EventQueue& operator = (EventQueue const& other) = delete;
+
+    // Add @p event. Called from any thread, never blocks.
+    // Returns false if the queue is full.
+    bool push(T const& event)
+    {
+        auto pos  = tail_.load(std::memory_order_relaxed);
+        auto slot = static_cast<Slot*>(nullptr);
+
+        // Claim the slot at the tail. Its sequence equals the position
+        // if it is free, otherwise the consumer hasn't caught up yet.
+        while (true)
+        {
+            slot = &slots_[pos & mask_];
+
+            auto seq  = slot->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq - pos);
+
+            if (diff == 0)
+            {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Publish the event to the consumer
+        slot->event = event;
+        slot->seq.store(pos + 1, std::memory_order_release);
+
+        // Wake the consumer, unless it was already woken and didn't drain yet.
+        if (!signaled_.exchange(true, std::memory_order_acq_rel))
+        {
+            signal_event(event_.get());
+        }
+        return true;
+    }
+
+    // Call @p handler for each queued event. Must only be called
+    // from the consumer thread. Returns the number of events.
+    template<typename Handler>
+    std::size_t drain(Handler&& handler)
+    {
+        // Rearm the wakeup first. Events pushed from now on signal again.
+        clear_event(event_.get());
+        signaled_.exchange(false, std::memory_order_acq_rel);
+
+        auto count = std::size_t(0);
+        while (true)
+        {
+            auto& slot = slots_[head_ & mask_];
+            if (slot.seq.load(std::memory_order_acquire) != (head_ + 1))
+            {
+                break;
+            }
+
+            // Copy event and hand the slot back to the producers
+            auto event = slot.event;
+            slot.seq.store(head_ + mask_ + 1, std::memory_order_release);
+            head_ += 1;
+
+            handler(event);
+            count += 1;
+        }
+        return count;
+    }
+
+    // Get eventfd to wait for. Readable while events are pending.
+    int get_fd() const
+    {
+        return event_.get();
+    }
+
+    // Get bytes allocated by the queue.
+    std::size_t get_memory() const
+    {
+        return slots_.capacity() * sizeof(Slot);
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<std::size_t> seq;
+        T                        event;
+    };
+
+    static std::size_t round_capacity(std::size_t capacity)
+    {
+        auto result = std::size_t(2);
+        while (result < capacity)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    std::vector<Slot>                    slots_;
+    std::size_t                          mask_;
+
+    // Producers and the consumer work on separate cache lines.
+    alignas(64) std::atomic<std::size_t> tail_;
+    alignas(64) std::size_t              head_;
+    alignas(64) std::atomic_bool         signaled_;
+    FileDescriptor                       event_;
+};
+
+#endif // EVENTQUEUE_HPP_201812311720
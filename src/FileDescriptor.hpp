@@ -0,0 +1,83 @@
+/**
+ * @file      FileDescriptor.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Owning wrapper for posix file descriptors.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef FILEDESCRIPTOR_HPP_201812271942
+#define FILEDESCRIPTOR_HPP_201812271942
+
+#include <unistd.h>
+
+// Owns a file descriptor and closes it on destruction.
+class FileDescriptor
+{
+public:
+    // Constructor: Take ownership of @p fd. Negative values are invalid.
+    explicit FileDescriptor(int fd = -1)
+        : fd_(fd)
+    {
+    }
+
+    ~FileDescriptor()
+    {
+        reset();
+    }
+
+    // Enable Move, disable Copy Semantics
+    FileDescriptor(FileDescriptor&& other) noexcept
+        : fd_(other.release())
+    {
+    }
+
+    FileDescriptor& operator = (FileDescriptor&& other) noexcept
+    {
+        reset(other.release());
+        return *this;
+    }
+
+    FileDescriptor(FileDescriptor const& other) = delete;
+    FileDescriptor& operator = (FileDescriptor const& other) = delete;
+
+    // Get raw descriptor.
+    int get() const
+    {
+        return fd_;
+    }
+
+    // Check if the owned descriptor is valid.
+    bool is_valid() const
+    {
+        return fd_ >= 0;
+    }
+
+    // Give up ownership without closing the descriptor.
+    int release()
+    {
+        auto fd = fd_;
+        fd_ = -1;
+        return fd;
+    }
+
+    // Close the owned descriptor and take ownership of @p fd.
+    void reset(int fd = -1)
+    {
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+        fd_ = fd;
+    }
+
+private:
+    int fd_;
+};
+
+#endif // FILEDESCRIPTOR_HPP_201812271942
@@ -0,0 +1,176 @@
+/**
+ * @file      FlatHashMap.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Open addressing hash map for small trivial keys and values.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef FLATHASHMAP_HPP_201812281530
+#define FLATHASHMAP_HPP_201812281530
+
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include <functional>
+
+// Hash map storing all entries in a single contiguous array. Collisions are
+// resolved by linear probing, erasing shifts following entries back instead
+// of leaving tombstones. Meant for small trivially copyable keys and values.
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatHashMap
+{
+public:
+    // Constructor: @p capacity is the initial number of buckets.
+    explicit FlatHashMap(std::size_t capacity = 16)
+        : buckets_(round_capacity(capacity))
+        , size_(0)
+    {
+    }
+
+    // Insert or overwrite value of @p key.
+    void insert(Key const& key, Value const& value)
+    {
+        // Keep load factor below 1/2, probe sequences stay short.
+        if (2 * (size_ + 1) > buckets_.size())
+        {
+            rehash(2 * buckets_.size());
+        }
+
+        auto pos = index_of(key);
+        while (buckets_[pos].used)
+        {
+            if (buckets_[pos].key == key)
+            {
+                buckets_[pos].value = value;
+                return;
+            }
+            pos = next(pos);
+        }
+        buckets_[pos] = Bucket{key, value, true};
+        ++size_;
+    }
+
+    // Lookup value of @p key.
+    std::optional<Value> find(Key const& key) const
+    {
+        for (auto pos = index_of(key); buckets_[pos].used; pos = next(pos))
+        {
+            if (buckets_[pos].key == key)
+            {
+                return buckets_[pos].value;
+            }
+        }
+        return {};
+    }
+
+    // Check if @p key is stored.
+    bool contains(Key const& key) const
+    {
+        return find(key).has_value();
+    }
+
+    // Erase @p key. Returns false if the key was not stored.
+    bool erase(Key const& key)
+    {
+        auto pos = index_of(key);
+        while (buckets_[pos].used && !(buckets_[pos].key == key))
+        {
+            pos = next(pos);
+        }
+
+        if (!buckets_[pos].used)
+        {
+            return false;
+        }
+
+        // Shift back following entries that would be unreachable otherwise.
+        auto hole = pos;
+        for (pos = next(pos); buckets_[pos].used; pos = next(pos))
+        {
+            auto home = index_of(buckets_[pos].key);
+            if (distance(home, pos) >= distance(hole, pos))
+            {
+                buckets_[hole] = buckets_[pos];
+                hole = pos;
+            }
+        }
+        buckets_[hole].used = false;
+        --size_;
+        return true;
+    }
+
+    // Get number of stored entries.
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    // Remove all entries.
+    void clear()
+    {
+        for (auto& bucket : buckets_)
+        {
+            bucket.used = false;
+        }
+        size_ = 0;
+    }
+
+private:
+    struct Bucket
+    {
+        Key   key   = Key();
+        Value value = Value();
+        bool  used  = false;
+    };
+
+    static std::size_t round_capacity(std::size_t capacity)
+    {
+        auto result = std::size_t(16);
+        while (result < capacity)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    std::size_t index_of(Key const& key) const
+    {
+        return Hash()(key) & (buckets_.size() - 1);
+    }
+
+    std::size_t next(std::size_t pos) const
+    {
+        return (pos + 1) & (buckets_.size() - 1);
+    }
+
+    std::size_t distance(std::size_t from, std::size_t to) const
+    {
+        return (to - from) & (buckets_.size() - 1);
+    }
+
+    void rehash(std::size_t capacity)
+    {
+        auto old = std::vector<Bucket>(round_capacity(capacity));
+        old.swap(buckets_);
+        size_ = 0;
+
+        for (auto const& bucket : old)
+        {
+            if (bucket.used)
+            {
+                insert(bucket.key, bucket.value);
+            }
+        }
+    }
+
+    std::vector<Bucket> buckets_;
+    std::size_t         size_;
+};
+
+#endif // FLATHASHMAP_HPP_201812281530
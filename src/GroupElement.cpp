@@ -11,68 +11,217 @@
  * directory for more details.
  */
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 #include "Constants.hpp"
+#include "Util.hpp"
 #include "GroupElement.hpp"
 
-GroupElement::GroupElement ( std::optional<std::string> const&            name
-                           , std::vector<ObserverElement::Pointer> const& observers
+namespace
+{
+// Percentiles shown in the group summary
+struct Percentile
+{
+    char const* label;
+    unsigned    percent;
+};
+
+Percentile const summary_percentiles[] = { {ui_header_rtt_p50, 50}
+                                         , {ui_header_rtt_p95, 95}
+                                         , {ui_header_rtt_p99, 99}
+                                         };
+
+// Get width of the group summary: Each label followed by its value.
+unsigned get_summary_width()
+{
+    auto width = std::size_t(0);
+    for (auto const& [label, percent] : summary_percentiles)
+    {
+        width += std::strlen(ui_field_space) + std::strlen(label) + 1 + ui_rtt_width;
+    }
+    return static_cast<unsigned>(width);
+}
+} // anon namespace
+
+GroupElement::GroupElement ( std::optional<std::string> const& name
+                           , HostTable&                        hosts
+                           , HostTable::Index                  first
+                           , HostTable::Index                  last
                            )
     : name_(name)
-    , observers_(observers)
+    , hosts_(hosts)
+    , first_(first)
+    , last_(last)
+    , width_(0)
+    , histogram_()
+    , summary_pos_()
+    , summary_len_(0)
 {
+    // Hosts showing percentiles feed a histogram of the entire group,
+    // summarized next to the group name.
+    if (hosts_.has_histogram())
+    {
+        histogram_ = std::make_shared<RttHistogram>();
+        hosts_.set_group_histogram(first_, last_, histogram_);
+    }
+
+    // Rows don't change their width, it is calculated only once.
+    width_ = static_cast<unsigned>(name_.value_or("").size());
+    if (histogram_)
+    {
+        width_ += get_summary_width();
+    }
+    if (first_ != last_)
+    {
+        width_ = std::max(width_, hosts_.get_width());
+    }
+    width_ += 2 * ui_line_offset_x;
 }
 
 void GroupElement::draw(Window::Pointer wnd, Position& pos) const
 {
-    // Draw group name in case there is one.
-    if (name_)
-    {
-        // Calculate number of left characters, prevent underflow
-        auto chars_left = 0;
-        chars_left = wnd->get_width() - (2 * (ui_border_width + ui_line_offset_x));
-        chars_left = (chars_left < 0) ? 0 : chars_left;
+    // One host per line, using the entire line
+    auto grid  = Grid{1, wnd->get_width(), false};
+    auto shown = HostTable::Changed();
+    draw_lines(wnd, pos, 0, get_height(), grid, shown);
+}
+
+void GroupElement::draw_lines( Window::Pointer const& wnd
+                             , Position&              pos
+                             , unsigned               first
+                             , unsigned               count
+                             , Grid const&            grid
+                             , HostTable::Changed&    shown
+                             ) const
+{
+    auto last = std::min(first + count, get_height(grid));
+    auto skip = (name_ || histogram_) ? 1u : 0u;
 
+    // Calculate number of left characters, prevent underflow
+    auto chars_left = 0;
+    chars_left = wnd->get_width() - (2 * (ui_border_width + ui_line_offset_x));
+    chars_left = (chars_left < 0) ? 0 : chars_left;
+
+    // Draw group name and summary in case there is one and its line is in range.
+    if (skip && (first == 0) && (first < last))
+    {
         pos = Position( ui_border_width + ui_line_offset_x
                       , pos.y + ui_line_offset_y
                       );
 
-        wnd->move_to(pos);
-        wnd->set_underlined();
-        wnd->add_string(name_.value(), chars_left);
-        wnd->unset_underlined();
+        auto room = static_cast<std::size_t>(chars_left);
+        auto used = std::size_t(0);
+
+        if (name_)
+        {
+            wnd->move_to(pos);
+            wnd->set_underlined();
+            wnd->add_string(name_.value(), room);
+            wnd->unset_underlined();
+            used = std::min(name_->size(), room);
+        }
+
+        summary_pos_ = Position(pos.x + static_cast<unsigned>(used), pos.y);
+        summary_len_ = room - used;
+        draw_summary(wnd);
     }
 
-    // Draw Groups Elements
-    for (auto obs : observers_)
+    // Draw hosts in range, the name occupies the first line.
+    for (auto line = std::max(first, skip); line < last; ++line)
     {
         pos = Position( ui_border_width + ui_line_offset_x
                       , pos.y + ui_line_offset_y
                       );
 
-        wnd->move_to(pos);
-        obs->draw(wnd, pos);
+        auto begin = first_ + (line - skip) * grid.per_line;
+        auto end   = std::min(begin + grid.per_line, last_);
+        auto room  = static_cast<unsigned>(chars_left);
+
+        for (auto host = begin; host < end; ++host)
+        {
+            auto cell = Position(pos.x + (host - begin) * grid.cell_width, pos.y);
+            auto used = cell.x - pos.x;
+
+            if (used >= room)
+            {
+                break;
+            }
+
+            if (grid.state_only)
+            {
+                hosts_.draw_cell(wnd, host, cell);
+            }
+            else
+            {
+                hosts_.draw_row(wnd, host, cell, std::min(grid.cell_width, room - used));
+            }
+            shown.push_back(host);
+        }
     }
 }
 
 unsigned GroupElement::get_height() const
 {
-    auto height = static_cast<unsigned>(observers_.size());
+    auto height = last_ - first_;
 
-    // In case the groups has a name: reserve a line for it.
-    if (name_)
+    // In case the groups has a name or summary: reserve a line for it.
+    if (name_ || histogram_)
     {
         height += 1;
     }
     return height;
 }
 
-unsigned GroupElement::get_width() const
+unsigned GroupElement::get_height(Grid const& grid) const
+{
+    auto per_line = std::max(grid.per_line, 1u);
+    auto lines    = (last_ - first_ + per_line - 1) / per_line;
+
+    // In case the groups has a name or summary: reserve a line for it.
+    return (name_ || histogram_) ? (lines + 1) : lines;
+}
+
+bool GroupElement::has_summary() const
+{
+    return histogram_ != nullptr;
+}
+
+void GroupElement::draw_summary(Window::Pointer const& wnd) const
 {
-    auto width = static_cast<unsigned>(name_.value_or("").size());
+    if (!histogram_)
+    {
+        return;
+    }
+
+    // Assemble the summary in a fixed size buffer, each value padded to
+    // the same width. A redraw overwrites the previous summary entirely.
+    char buffer[128];
+    auto end = std::begin(buffer);
 
-    for (auto obs : observers_)
+    for (auto const& [label, percent] : summary_percentiles)
     {
-        width = std::max(width, obs->get_width());
+        end = std::copy_n(ui_field_space, std::strlen(ui_field_space), end);
+        end = std::copy_n(label, std::strlen(label), end);
+        *end++ = ' ';
+
+        auto value = end;
+        if (histogram_->is_measured())
+        {
+            end = format_rtt(value, value + ui_rtt_width, histogram_->get_percentile(percent));
+        }
+        if (end == value)
+        {
+            end = std::copy_n(ui_rtt_none, std::strlen(ui_rtt_none), value);
+        }
+        end = std::fill_n(end, ui_rtt_width - static_cast<unsigned>(end - value), ' ');
     }
-    return width + 2 * ui_line_offset_x;
+
+    wnd->move_to(summary_pos_);
+    wnd->add_string(buffer, std::min(static_cast<std::size_t>(end - buffer), summary_len_));
+}
+
+unsigned GroupElement::get_width() const
+{
+    return width_;
 }
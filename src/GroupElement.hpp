@@ -15,10 +15,12 @@
 #define GROUPELEMENT_HPP_201804081223
 
 #include <memory>
+#include <vector>
 #include <cstdint>
 #include <optional>
 #include "Element.hpp"
-#include "ObserverElement.hpp"
+#include "HostTable.hpp"
+#include "RttHistogram.hpp"
 
 // ui element representing a group of hosts
 class GroupElement : public Element
@@ -26,10 +28,22 @@ class GroupElement : public Element
 public:
     using Pointer = std::shared_ptr<GroupElement>;
 
-    // Constructor: A group can have a optional name and a list of
-    // ObserverElements associated with this group
-    GroupElement( std::optional<std::string> const&            name
-                , std::vector<ObserverElement::Pointer> const& observers
+    // Arrangement of the hosts: @p per_line hosts share a line, each
+    // one @p cell_width characters wide. With @p state_only each host
+    // is drawn as a single colored cell.
+    struct Grid
+    {
+        unsigned per_line;
+        unsigned cell_width;
+        bool     state_only;
+    };
+
+    // Constructor: A group can have a optional name and holds the
+    // hosts [@p first, @p last) of @p hosts.
+    GroupElement( std::optional<std::string> const& name
+                , HostTable&                        hosts
+                , HostTable::Index                  first
+                , HostTable::Index                  last
                 );
 
     virtual ~GroupElement() = default;
@@ -39,9 +53,40 @@ public:
     virtual unsigned get_height() const override;
     virtual unsigned get_width() const override;
 
+    // Get height in lines with hosts arranged in @p grid.
+    unsigned get_height(Grid const& grid) const;
+
+    // Returns true if the group shows a percentile summary of all its hosts.
+    bool has_summary() const;
+
+    // Redraw the percentile summary at the position of the last draw.
+    void draw_summary(Window::Pointer const& wnd) const;
+
+    // Draw @p count lines starting with line @p first on @p wnd, hosts are
+    // arranged in @p grid. Only these lines are visited. Drawn hosts are
+    // appended to @p shown.
+    void draw_lines( Window::Pointer const& wnd
+                   , Position&              pos
+                   , unsigned               first
+                   , unsigned               count
+                   , Grid const&            grid
+                   , HostTable::Changed&    shown
+                   ) const;
+
 private:
     std::optional<std::string>            name_;
-    std::vector<ObserverElement::Pointer> observers_;
+    HostTable&                            hosts_;
+    HostTable::Index                      first_;
+    HostTable::Index                      last_;
+    unsigned                              width_;
+
+    // Round trip times of all hosts in the group, in case
+    // percentiles are shown.
+    RttHistogram::Pointer                 histogram_;
+
+    // Summary position and room of the last draw. Only used by the ui thread.
+    mutable Position                      summary_pos_;
+    mutable std::size_t                   summary_len_;
 };
 
 #endif // GROUPELEMENT_HPP_201804081223
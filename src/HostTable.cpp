@@ -0,0 +1,432 @@
+/**
+ * @file      HostTable.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Dense state table of all monitored hosts.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include "Constants.hpp"
+#include "Util.hpp"
+#include "HostTable.hpp"
+
+namespace
+{
+// Group of hosts without a group histogram
+std::uint32_t const no_group = std::numeric_limits<std::uint32_t>::max();
+
+// Returns true if @p field is a percentile of the round trip time.
+bool is_percentile(Field field)
+{
+    return (field == Field::RttP50) || (field == Field::RttP95) || (field == Field::RttP99);
+}
+
+// Returns true if @p field is drawn from the round trip time statistics.
+bool is_measure(Field field)
+{
+    switch (field)
+    {
+        case Field::RttLast:
+        case Field::RttMin:
+        case Field::RttAvg:
+        case Field::RttMax:
+        case Field::RttJitter:
+        case Field::RttP50:
+        case Field::RttP95:
+        case Field::RttP99:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+// Clamp @p value to the range of a position in a slot.
+std::uint16_t to_slot(std::size_t value)
+{
+    return static_cast<std::uint16_t>(std::min(value, std::size_t(std::numeric_limits<std::uint16_t>::max())));
+}
+} // anon namespace
+
+// Feeds probe results of a single host into the table.
+class HostTable::Observer : public ProbeObserver
+{
+public:
+    Observer(HostTable& table, Index index)
+        : table_(table)
+        , index_(index)
+    {
+    }
+
+    // ProbeObserver interface implementation. Executed in the thread
+    // context of the probe scheduler
+    virtual void probe_finished(ProbeResult const& result) override
+    {
+        table_.probe_finished(index_, result);
+    }
+
+private:
+    HostTable& table_;
+    Index      index_;
+};
+
+HostTable::HostTable( std::vector<ConfigGlobal::FieldFmt> const& fmt
+                    , StringArena const&                         strings
+                    , std::size_t                                capacity
+                    )
+    : fmt_(fmt)
+    , measures_()
+    , row_len_(0)
+    , capacity_(static_cast<Index>(capacity))
+    , size_(0)
+    , strings_(strings)
+    , hosts_()
+    , available_(std::make_unique<std::atomic_bool[]>(capacity))
+    , changed_at_(std::make_unique<std::atomic<Clock::rep>[]>(capacity))
+    , stats_()
+    , histograms_()
+    , groups_()
+    , group_of_()
+    , dirty_(std::make_unique<std::atomic_bool[]>(capacity))
+    , queue_(capacity)
+    , slots_(std::make_unique<Slot[]>(capacity))
+    , row_()
+{
+    // All rows share the same layout. Round trip times change with each
+    // probe, they are drawn separately into the room reserved for them.
+    for (auto const& [type, len] : fmt_)
+    {
+        if (is_measure(type))
+        {
+            measures_.push_back(Measure{type, static_cast<unsigned>(row_len_), len});
+        }
+        row_len_ += len + std::strlen(ui_field_space);
+    }
+    hosts_.reserve(capacity);
+    row_.reserve(row_len_);
+
+    // Statistics and histograms are only kept if they are shown.
+    if (!measures_.empty())
+    {
+        stats_ = std::make_unique<RttStats[]>(capacity);
+    }
+    if (std::any_of(measures_.begin(), measures_.end(), [] (auto const& m) {return is_percentile(m.field);}))
+    {
+        histograms_ = std::make_unique<RttHistogram[]>(capacity);
+        group_of_   = std::make_unique<std::uint32_t[]>(capacity);
+        std::fill_n(group_of_.get(), capacity, no_group);
+    }
+}
+
+HostTable::Index HostTable::add_host(ConfigHost const& host)
+{
+    if (size_ >= capacity_)
+    {
+        abort("Host table is full");
+    }
+
+    hosts_.push_back(Host{ host.fqhn
+                         , host.alias
+                         , host.role
+                         , host.device
+                         , static_cast<std::uint32_t>(host.interval.count())
+                         , host.port
+                         , host.protocol
+                         });
+    return size_++;
+}
+
+ProbeObserver::Pointer HostTable::make_observer(Index index)
+{
+    return std::make_shared<Observer>(*this, index);
+}
+
+HostTable::Index HostTable::size() const
+{
+    return size_;
+}
+
+unsigned HostTable::get_width() const
+{
+    return static_cast<unsigned>(row_len_ + std::max( std::strlen(ui_status_available)
+                                                    , std::strlen(ui_status_unavailable)
+                                                    )
+                                );
+}
+
+HostTable::Clock::time_point HostTable::get_last_change(Index index) const
+{
+    return Clock::time_point(Clock::duration(changed_at_[index].load()));
+}
+
+std::size_t HostTable::get_memory() const
+{
+    // Arrays sized by the capacity, statistics and histograms only if shown
+    auto per_host = sizeof(std::atomic_bool)             // available_
+                  + sizeof(std::atomic<Clock::rep>)      // changed_at_
+                  + sizeof(std::atomic_bool)             // dirty_
+                  + sizeof(Slot)
+                  + (stats_      ? sizeof(RttStats)      : 0)
+                  + (histograms_ ? sizeof(RttHistogram)  : 0)
+                  + (group_of_   ? sizeof(std::uint32_t) : 0);
+
+    return hosts_.capacity() * sizeof(Host)
+         + capacity_ * per_host
+         + queue_.get_memory()
+         + row_.capacity();
+}
+
+bool HostTable::has_histogram() const
+{
+    return histograms_ != nullptr;
+}
+
+void HostTable::set_group_histogram(Index first, Index last, RttHistogram::Pointer const& histogram)
+{
+    if (!group_of_)
+    {
+        return;
+    }
+
+    auto group = static_cast<std::uint32_t>(groups_.size());
+    groups_.push_back(histogram);
+    std::fill(group_of_.get() + first, group_of_.get() + last, group);
+}
+
+void HostTable::draw_row(Window::Pointer const& wnd, Index index, Position const& pos, std::size_t width) const
+{
+    format_row(index);
+    wnd->move_to(pos);
+    wnd->add_string(row_.data(), std::min(row_len_, width));
+
+    // Remember the row for later updates
+    slots_[index] = Slot{to_slot(pos.x), to_slot(pos.y), to_slot(width), true, false};
+    draw_measures(wnd, index);
+    draw_state(wnd, index);
+}
+
+void HostTable::draw_cell(Window::Pointer const& wnd, Index index, Position const& pos) const
+{
+    slots_[index] = Slot{to_slot(pos.x), to_slot(pos.y), 1, true, true};
+    draw_state(wnd, index);
+}
+
+void HostTable::draw_status(Window::Pointer const& wnd, Index index)
+{
+    // Clear dirty before reading the state. A change after this
+    // point queues the host again.
+    dirty_[index] = false;
+    if (slots_[index].visible)
+    {
+        if (slots_[index].cell == false)
+        {
+            draw_measures(wnd, index);
+        }
+        draw_state(wnd, index);
+    }
+}
+
+void HostTable::hide(Index index)
+{
+    slots_[index].visible = false;
+}
+
+int HostTable::get_fd() const
+{
+    return queue_.get_fd();
+}
+
+void HostTable::probe_finished(Index index, ProbeResult const& result)
+{
+    // Failed probes don't measure a round trip time
+    if (result.available && stats_)
+    {
+        stats_[index].sample(result.rtt);
+
+        if (histograms_)
+        {
+            histograms_[index].record(result.rtt);
+        }
+        if (group_of_ && (group_of_[index] != no_group))
+        {
+            groups_[group_of_[index]]->record(result.rtt);
+        }
+
+        // Shown round trip times change with each successful probe
+        available_[index] = true;
+        notify_changed(index);
+        return;
+    }
+    update_state(index, result.available);
+}
+
+void HostTable::update_state(Index index, bool available)
+{
+    // Probes report every result. Only a state change requires a redraw.
+    if (available_[index] == available)
+    {
+        return;
+    }
+
+    // State change occured. Update internal state and notify ui thread
+    // to redraw this host.
+    available_[index]  = available;
+    changed_at_[index] = Clock::now().time_since_epoch().count();
+    notify_changed(index);
+}
+
+void HostTable::format_row(Index index) const
+{
+    auto const& host = hosts_[index];
+
+    // The capacity is reserved, formatting doesn't allocate
+    row_.clear();
+    for (auto const& [type, len] : fmt_)
+    {
+        switch(type)
+        {
+            case Field::Fqhn:
+                append_and_fill(row_, strings_.get(host.fqhn), len);
+                break;
+
+            case Field::Alias:
+                append_and_fill(row_, strings_.get(host.alias), len);
+                break;
+
+            case Field::Role:
+                append_and_fill(row_, strings_.get(host.role), len);
+                break;
+
+            case Field::Device:
+                append_and_fill(row_, strings_.get(host.device), len);
+                break;
+
+            case Field::Protocol:
+                append_and_fill(row_, make_proto_port_string(host.protocol, host.port), len);
+                break;
+
+            case Field::Interval:
+                append_and_fill(row_, make_interval_string(std::chrono::seconds(host.interval)), len);
+                break;
+
+            default:
+                append_and_fill(row_, "", len);
+        }
+
+        // Append spacer between fields
+        row_.append(ui_field_space);
+    }
+}
+
+void HostTable::notify_changed(Index index)
+{
+    // Skip hosts already waiting for a redraw
+    if (dirty_[index].exchange(true))
+    {
+        return;
+    }
+
+    // Never blocks. The queue holds all hosts, a full queue is not
+    // expected. Allow queuing with the next change in that case.
+    if (!queue_.push(index))
+    {
+        dirty_[index] = false;
+    }
+}
+
+void HostTable::draw_state(Window::Pointer const& wnd, Index index) const
+{
+    auto const& slot = slots_[index];
+    auto available   = available_[index].load();
+    auto color       = available ? Window::Color::Green : Window::Color::Red;
+
+    // Cells show the state by their background color only
+    if (slot.cell)
+    {
+        wnd->move_to(Position(slot.x, slot.y));
+        wnd->set_color(Window::Color::Default, color);
+        wnd->add_string(ui_heatmap_cell, 1);
+        wnd->unset_color();
+        return;
+    }
+
+    // The status follows the row text in the room left
+    auto status = available ? ui_status_available : ui_status_unavailable;
+    auto len    = std::strlen(status);
+    auto room   = (slot.width > row_len_) ? (slot.width - row_len_) : 0;
+    auto width  = std::min( std::max(std::strlen(ui_status_available), std::strlen(ui_status_unavailable))
+                          , room
+                          );
+
+    wnd->move_to(Position(slot.x + static_cast<unsigned>(row_len_), slot.y));
+    wnd->set_foreground_color(color);
+    wnd->add_string(status, room);
+    wnd->unset_color();
+
+    // Overwrite the rest of a longer previous status
+    if (len < width)
+    {
+        wnd->add_horizontal_line(' ', static_cast<unsigned>(width - len));
+    }
+}
+
+void HostTable::draw_measures(Window::Pointer const& wnd, Index index) const
+{
+    auto const& slot = slots_[index];
+
+    // Fixed size buffer, a frame doesn't allocate
+    char buffer[32];
+
+    for (auto const& [field, offset, len] : measures_)
+    {
+        // Measures are ordered by offset, the remaining ones are cut off
+        if (offset >= slot.width)
+        {
+            break;
+        }
+
+        auto room  = std::min(static_cast<std::size_t>(len), static_cast<std::size_t>(slot.width - offset));
+        auto first = static_cast<char*>(buffer);
+        auto last  = first;
+        auto const& stats = stats_[index];
+
+        if (stats.is_measured())
+        {
+            switch (field)
+            {
+                case Field::RttLast:   last = format_rtt(first, std::end(buffer), stats.get_last());   break;
+                case Field::RttMin:    last = format_rtt(first, std::end(buffer), stats.get_min());    break;
+                case Field::RttAvg:    last = format_rtt(first, std::end(buffer), stats.get_avg());    break;
+                case Field::RttMax:    last = format_rtt(first, std::end(buffer), stats.get_max());    break;
+                case Field::RttJitter: last = format_rtt(first, std::end(buffer), stats.get_jitter()); break;
+                case Field::RttP50:    last = format_rtt(first, std::end(buffer), histograms_[index].get_percentile(50)); break;
+                case Field::RttP95:    last = format_rtt(first, std::end(buffer), histograms_[index].get_percentile(95)); break;
+                case Field::RttP99:    last = format_rtt(first, std::end(buffer), histograms_[index].get_percentile(99)); break;
+                default:               break;
+            }
+        }
+        else
+        {
+            last = std::copy_n(ui_rtt_none, std::strlen(ui_rtt_none), first);
+        }
+
+        // Overwrite the rest of a longer previous value
+        auto used = std::min(static_cast<std::size_t>(last - first), room);
+
+        wnd->move_to(Position(slot.x + offset, slot.y));
+        wnd->add_string(first, used);
+        if (used < room)
+        {
+            wnd->add_horizontal_line(' ', static_cast<unsigned>(room - used));
+        }
+    }
+}
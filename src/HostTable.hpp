@@ -0,0 +1,191 @@
+/**
+ * @file      HostTable.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Dense state table of all monitored hosts.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef HOSTTABLE_HPP_201901021130
+#define HOSTTABLE_HPP_201901021130
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "Config.hpp"
+#include "EventQueue.hpp"
+#include "Probe.hpp"
+#include "RttHistogram.hpp"
+#include "RttStats.hpp"
+#include "StringArena.hpp"
+#include "Window.hpp"
+
+// State of all hosts in contiguous arrays, a host is an index into them.
+// Hosts refer to their text in the string arena of the config, rows are
+// formatted when drawn. Probe threads update a host through its observer,
+// the ui thread reads the state without locking and draws hosts by index.
+// A changed host is queued for the ui thread, at most once until it is drawn.
+class HostTable
+{
+public:
+    using Clock   = std::chrono::steady_clock;
+    using Index   = std::uint32_t;
+    using Changed = std::vector<Index>;
+
+    // Constructor: Reserve room for @p capacity hosts, their rows show the
+    // fields in @p fmt. The text of the hosts is in @p strings, it must
+    // outlive the table.
+    HostTable( std::vector<ConfigGlobal::FieldFmt> const& fmt
+             , StringArena const&                         strings
+             , std::size_t                                capacity
+             );
+
+    // Disable Copy and Move Semantics, observers refer to the table.
+    HostTable(HostTable const& other) = delete;
+    HostTable& operator = (HostTable const& other) = delete;
+
+    // Add @p host. Returns its index. At most capacity hosts can be added.
+    Index add_host(ConfigHost const& host);
+
+    // Make observer feeding probe results of host @p index into the table.
+    ProbeObserver::Pointer make_observer(Index index);
+
+    // Get number of hosts.
+    Index size() const;
+
+    // Get width of a row including the status.
+    unsigned get_width() const;
+
+    // Get time of the last state change of host @p index. Hosts
+    // that never changed return the epoch of the clock.
+    Clock::time_point get_last_change(Index index) const;
+
+    // Get bytes allocated by the table.
+    std::size_t get_memory() const;
+
+    // Returns true if percentile fields are shown. Only then
+    // histograms are kept.
+    bool has_histogram() const;
+
+    // Record round trip times of hosts [@p first, @p last) into @p histogram
+    // of their group as well. Call before probing starts.
+    void set_group_histogram(Index first, Index last, RttHistogram::Pointer const& histogram);
+
+    // Draw host @p index at @p pos with up to @p width characters.
+    void draw_row(Window::Pointer const& wnd, Index index, Position const& pos, std::size_t width) const;
+
+    // Draw only the state of host @p index as a single colored cell at @p pos.
+    void draw_cell(Window::Pointer const& wnd, Index index, Position const& pos) const;
+
+    // Redraw only the status and round trip times of host @p index at the
+    // position of the last draw. Call for each host in the changed list.
+    void draw_status(Window::Pointer const& wnd, Index index);
+
+    // Mark host @p index as scrolled out of view, draw_status() does
+    // nothing until the next draw_row() or draw_cell().
+    void hide(Index index);
+
+    // Call @p handler with the index of each changed host. Must only be called
+    // from the ui thread. Returns the number of changed hosts.
+    template<typename Handler>
+    std::size_t drain(Handler&& handler)
+    {
+        return queue_.drain(std::forward<Handler>(handler));
+    }
+
+    // Get eventfd signaling changed hosts.
+    int get_fd() const;
+
+private:
+    class Observer;
+
+    // Fields of a host shown in its row. Text is in the string arena.
+    struct Host
+    {
+        StringArena::Id fqhn;
+        StringArena::Id alias;
+        StringArena::Id role;
+        StringArena::Id device;
+        std::uint32_t   interval;
+        std::uint16_t   port;
+        Protocol        protocol;
+    };
+
+    // Round trip time field at @p offset in a row, @p len characters wide.
+    struct Measure
+    {
+        Field    field;
+        unsigned offset;
+        unsigned len;
+    };
+
+    // Row position and room of the last draw. Only used by the ui thread.
+    struct Slot
+    {
+        std::uint16_t x;
+        std::uint16_t y;
+        std::uint16_t width;
+        bool          visible;
+        bool          cell;
+    };
+
+    // Add probe result of host @p index. Executed in the thread
+    // context of the probe scheduler.
+    void probe_finished(Index index, ProbeResult const& result);
+
+    // Update availability of host @p index and queue it in case it changed.
+    void update_state(Index index, bool available);
+
+    // Format row of host @p index into row_.
+    void format_row(Index index) const;
+
+    // Queue host @p index for a redraw, unless it is already waiting for one.
+    void notify_changed(Index index);
+
+    // Draw status of host @p index at the last position.
+    void draw_state(Window::Pointer const& wnd, Index index) const;
+
+    // Draw round trip time fields of host @p index into its last row.
+    void draw_measures(Window::Pointer const& wnd, Index index) const;
+
+    // Layout of a row: The fields from the format and the
+    // round trip time fields drawn into them.
+    std::vector<ConfigGlobal::FieldFmt>            fmt_;
+    std::vector<Measure>                           measures_;
+    std::size_t                                    row_len_;
+    Index                                          capacity_;
+    Index                                          size_;
+
+    // Shown fields of each host and their text
+    StringArena const&                             strings_;
+    std::vector<Host>                              hosts_;
+
+    // Written by the probe threads, read by the ui thread without locking.
+    // Statistics and histograms exist only if their fields are shown.
+    std::unique_ptr<std::atomic_bool[]>            available_;
+    std::unique_ptr<std::atomic<Clock::rep>[]>     changed_at_;
+    std::unique_ptr<RttStats[]>                    stats_;
+    std::unique_ptr<RttHistogram[]>                histograms_;
+    std::vector<RttHistogram::Pointer>             groups_;
+    std::unique_ptr<std::uint32_t[]>               group_of_;
+
+    // Set on a state change until the ui thread redraws the status.
+    // Keeps a host from being queued twice.
+    std::unique_ptr<std::atomic_bool[]>            dirty_;
+    EventQueue<Index>                              queue_;
+
+    // Only used by the ui thread. Rows are formatted into row_ when drawn.
+    mutable std::unique_ptr<Slot[]>                slots_;
+    mutable std::string                            row_;
+};
+
+#endif // HOSTTABLE_HPP_201901021130
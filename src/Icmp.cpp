@@ -0,0 +1,184 @@
+/**
+ * @file      Icmp.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     ICMP echo sockets and packet handling.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/ip_icmp.h>
+#include <netinet/icmp6.h>
+#include <arpa/inet.h>
+#include "Icmp.hpp"
+
+namespace
+{
+// Internet checksum (RFC 1071) over @p len bytes of @p buf.
+std::uint16_t checksum(std::uint8_t const* buf, std::size_t len)
+{
+    auto sum = std::uint32_t(0);
+
+    for (auto i = std::size_t(0); i + 1 < len; i += 2)
+    {
+        sum += static_cast<std::uint32_t>((buf[i] << 8) | buf[i + 1]);
+    }
+    if (len & 1)
+    {
+        sum += static_cast<std::uint32_t>(buf[len - 1] << 8);
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return htons(static_cast<std::uint16_t>(~sum));
+}
+} // namespace anon
+
+std::optional<IcmpSocket> open_icmp_socket(int family)
+{
+    auto proto = (family == AF_INET6) ? int(IPPROTO_ICMPV6) : int(IPPROTO_ICMP);
+    auto flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    auto sock  = IcmpSocket();
+
+    sock.family = family;
+    sock.fd.reset(::socket(family, SOCK_DGRAM | flags, proto));
+    if (!sock.fd.is_valid())
+    {
+        sock.raw = true;
+        sock.fd.reset(::socket(family, SOCK_RAW | flags, proto));
+    }
+
+    if (!sock.fd.is_valid())
+    {
+        return {};
+    }
+
+    // Raw ICMPv6 sockets receive any ICMPv6 message. Only echo replies are of interest.
+    if (sock.raw && (family == AF_INET6))
+    {
+        auto filter = icmp6_filter();
+        ICMP6_FILTER_SETBLOCKALL(&filter);
+        ICMP6_FILTER_SETPASS(ICMP6_ECHO_REPLY, &filter);
+        ::setsockopt(sock.fd.get(), IPPROTO_ICMPV6, ICMP6_FILTER, &filter, sizeof(filter));
+    }
+    return sock;
+}
+
+std::uint16_t get_icmp_echo_id(IcmpSocket const& sock, std::uint16_t fallback)
+{
+    if (sock.raw)
+    {
+        return fallback;
+    }
+
+    // Ping sockets use their local port as echo identifier. Bind to get one assigned.
+    auto addr     = sockaddr_storage();
+    auto addr_len = socklen_t(sizeof(addr));
+
+    std::memset(&addr, 0, sizeof(addr));
+    addr.ss_family = static_cast<sa_family_t>(sock.family);
+    ::bind( sock.fd.get()
+          , reinterpret_cast<sockaddr*>(&addr)
+          , (sock.family == AF_INET6) ? sizeof(sockaddr_in6) : sizeof(sockaddr_in)
+          );
+
+    if (::getsockname(sock.fd.get(), reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0)
+    {
+        return fallback;
+    }
+
+    auto port = (sock.family == AF_INET6) ? reinterpret_cast<sockaddr_in6*>(&addr)->sin6_port
+                                          : reinterpret_cast<sockaddr_in*>(&addr)->sin_port;
+    return ntohs(port);
+}
+
+std::size_t make_echo_request( int             family
+                             , IcmpEcho const& echo
+                             , std::uint8_t*   buf
+                             )
+{
+    std::memset(buf, 0, icmp_echo_size);
+
+    if (family == AF_INET6)
+    {
+        // Checksum is calculated by the kernel, it covers the IPv6 pseudo header.
+        auto hdr = reinterpret_cast<icmp6_hdr*>(buf);
+        hdr->icmp6_type = ICMP6_ECHO_REQUEST;
+        hdr->icmp6_id   = htons(echo.id);
+        hdr->icmp6_seq  = htons(echo.seq);
+    }
+    else
+    {
+        auto hdr = reinterpret_cast<icmphdr*>(buf);
+        hdr->type             = ICMP_ECHO;
+        hdr->un.echo.id       = htons(echo.id);
+        hdr->un.echo.sequence = htons(echo.seq);
+        hdr->checksum         = checksum(buf, icmp_echo_size);
+    }
+    return icmp_echo_size;
+}
+
+std::optional<IcmpEcho> parse_echo_reply( IcmpSocket const&   sock
+                                        , std::uint8_t const* buf
+                                        , std::size_t         len
+                                        )
+{
+    auto echo = IcmpEcho();
+
+    if (sock.family == AF_INET6)
+    {
+        if (len < sizeof(icmp6_hdr))
+        {
+            return {};
+        }
+
+        auto hdr = reinterpret_cast<icmp6_hdr const*>(buf);
+        if (hdr->icmp6_type != ICMP6_ECHO_REPLY)
+        {
+            return {};
+        }
+        echo.id  = ntohs(hdr->icmp6_id);
+        echo.seq = ntohs(hdr->icmp6_seq);
+    }
+    else
+    {
+        // Raw IPv4 sockets deliver the IP header as well. Skip it.
+        if (sock.raw)
+        {
+            if (len < sizeof(iphdr))
+            {
+                return {};
+            }
+
+            auto hdr_len = static_cast<std::size_t>(reinterpret_cast<iphdr const*>(buf)->ihl) * 4;
+            if (len < hdr_len)
+            {
+                return {};
+            }
+            buf += hdr_len;
+            len -= hdr_len;
+        }
+
+        if (len < sizeof(icmphdr))
+        {
+            return {};
+        }
+
+        auto hdr = reinterpret_cast<icmphdr const*>(buf);
+        if (hdr->type != ICMP_ECHOREPLY)
+        {
+            return {};
+        }
+        echo.id  = ntohs(hdr->un.echo.id);
+        echo.seq = ntohs(hdr->un.echo.sequence);
+    }
+    return echo;
+}
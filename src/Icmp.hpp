@@ -0,0 +1,64 @@
+/**
+ * @file      Icmp.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     ICMP echo sockets and packet handling.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef ICMP_HPP_201812271942
+#define ICMP_HPP_201812271942
+
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <sys/socket.h>
+#include "FileDescriptor.hpp"
+
+// ICMP socket of a given address family. Unprivileged ping sockets are
+// preferred, raw sockets are used if ping sockets are not permitted.
+struct IcmpSocket
+{
+    FileDescriptor fd;
+    int            family = AF_UNSPEC;
+    bool           raw    = false;
+};
+
+// Identifier and sequence number of an echo request or reply.
+struct IcmpEcho
+{
+    std::uint16_t id  = 0;
+    std::uint16_t seq = 0;
+};
+
+// Size of echo requests built by make_echo_request.
+std::size_t const icmp_echo_size = 16;
+
+// Open non-blocking ICMP socket for @p family (AF_INET or AF_INET6).
+// In case no socket can be opened, an empty optional is returned.
+std::optional<IcmpSocket> open_icmp_socket(int family);
+
+// Get echo identifier assigned by the kernel to @p sock. Raw sockets
+// have no identifier assigned, in this case @p fallback is returned.
+std::uint16_t get_icmp_echo_id(IcmpSocket const& sock, std::uint16_t fallback);
+
+// Write echo request with @p echo into @p buf. @p buf must be able to hold
+// at least icmp_echo_size bytes. Returns the number of bytes written.
+std::size_t make_echo_request( int             family
+                             , IcmpEcho const& echo
+                             , std::uint8_t*   buf
+                             );
+
+// Parse echo reply from @p buf as received on @p sock. Returns an empty
+// optional in case @p buf contains anything else but an echo reply.
+std::optional<IcmpEcho> parse_echo_reply( IcmpSocket const&   sock
+                                        , std::uint8_t const* buf
+                                        , std::size_t         len
+                                        );
+
+#endif // ICMP_HPP_201812271942
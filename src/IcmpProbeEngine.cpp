@@ -0,0 +1,412 @@
+/**
+ * @file      IcmpProbeEngine.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Probe engine sharing one icmp socket per address family.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <cerrno>
+#include <limits>
+#include <cstring>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include "Constants.hpp"
+#include "Util.hpp"
+#include "IcmpProbeEngine.hpp"
+
+using namespace std::chrono;
+
+namespace
+{
+// Epoll token of the eventfd signaling new submissions. The
+// sockets use the index of their family as token.
+std::uint64_t const event_token = std::numeric_limits<std::uint64_t>::max();
+
+// Max. size of a received packet. Anything larger is no echo reply of ours.
+std::size_t const max_packet_size = 512;
+
+// Number of echo sequence numbers.
+std::size_t const max_echo_seq = 1u << 16;
+} // namespace anon
+
+IcmpProbeEngine::IcmpProbeEngine(Completion completion)
+    : completion_(std::move(completion))
+    , epoll_(::epoll_create1(EPOLL_CLOEXEC))
+    , event_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    , families_()
+    , running_(true)
+    , thread_()
+    , mtx_()
+    , submitted_()
+    , probes_()
+    , free_slots_()
+    , deadlines_()
+    , backlog_()
+{
+    if (!epoll_.is_valid() || !event_.is_valid())
+    {
+        abort("Failed to setup icmp probe engine");
+    }
+
+    auto ev = epoll_event();
+    ev.events   = EPOLLIN;
+    ev.data.u64 = event_token;
+    ::epoll_ctl(epoll_.get(), EPOLL_CTL_ADD, event_.get(), &ev);
+
+    // Open shared sockets. Probes of a family without socket fail.
+    auto const af = std::array<int, 2>{AF_INET, AF_INET6};
+    for (auto i = std::size_t(0); i < families_.size(); ++i)
+    {
+        auto& family = families_[i];
+
+        family.sock = open_icmp_socket(af[i]);
+        if (!family.sock)
+        {
+            continue;
+        }
+
+        auto fd      = family.sock->fd.get();
+        auto buf_len = static_cast<int>(probe_icmp_buffer_size);
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buf_len, sizeof(buf_len));
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &buf_len, sizeof(buf_len));
+
+        family.echo_id = get_icmp_echo_id( family.sock.value()
+                                         , static_cast<std::uint16_t>(::getpid())
+                                         );
+        ev.events   = EPOLLIN;
+        ev.data.u64 = i;
+        ::epoll_ctl(epoll_.get(), EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    thread_ = std::thread([this] { run(); });
+}
+
+IcmpProbeEngine::~IcmpProbeEngine()
+{
+    running_ = false;
+    signal_event(event_.get());
+    thread_.join();
+}
+
+void IcmpProbeEngine::submit(std::vector<ProbeRequest> const& requests)
+{
+    {
+        auto lock = std::lock_guard<std::mutex>(mtx_);
+        submitted_.insert(submitted_.end(), requests.begin(), requests.end());
+    }
+
+    // Wakeup engine thread
+    signal_event(event_.get());
+}
+
+void IcmpProbeEngine::run()
+{
+    auto events    = std::vector<epoll_event>(probe_epoll_batch);
+    auto submitted = std::vector<ProbeRequest>();
+    auto blocked   = false;
+
+    while (running_)
+    {
+        // Retry soon in case a socket buffer was full.
+        auto timeout = next_timeout();
+        if (blocked && ((timeout < 0) || (timeout > 1)))
+        {
+            timeout = 1;
+        }
+
+        auto count = ::epoll_wait( epoll_.get()
+                                 , events.data()
+                                 , static_cast<int>(events.size())
+                                 , timeout
+                                 );
+
+        for (auto i = 0; i < count; ++i)
+        {
+            auto token = events[i].data.u64;
+
+            // New submissions: Queue them behind earlier ones.
+            if (token == event_token)
+            {
+                clear_event(event_.get());
+                {
+                    auto lock = std::lock_guard<std::mutex>(mtx_);
+                    submitted.swap(submitted_);
+                }
+                backlog_.insert(backlog_.end(), submitted.begin(), submitted.end());
+                submitted.clear();
+                continue;
+            }
+            receive_replies(families_[token]);
+        }
+
+        // Replies are handled first, a reply arriving right
+        // before its deadline must not be reported as unavailable.
+        expire_probes();
+
+        // Start probes in portions, replies are handled in between.
+        for (auto started = 0u; !backlog_.empty() && (started < probe_icmp_start_batch); ++started)
+        {
+            auto const& request = backlog_.front();
+
+            if (request.deadline <= Clock::now())
+            {
+                completion_(request.id, ProbeResult{false, microseconds(0)});
+            }
+            else if (!start_probe(request))
+            {
+                break;
+            }
+            backlog_.pop_front();
+        }
+
+        blocked = false;
+        for (auto& family : families_)
+        {
+            blocked = !send_requests(family) || blocked;
+        }
+    }
+}
+
+IcmpProbeEngine::Family* IcmpProbeEngine::get_family(Address const& addr)
+{
+    switch (addr.family())
+    {
+        case AF_INET:  return &families_[0];
+        case AF_INET6: return &families_[1];
+        default:       return nullptr;
+    }
+}
+
+bool IcmpProbeEngine::start_probe(ProbeRequest const& request)
+{
+    auto family = get_family(request.addr);
+    if (!family || !family->sock)
+    {
+        completion_(request.id, ProbeResult{false, microseconds(0)});
+        return true;
+    }
+
+    // All sequence numbers in use: Wait for probes to finish.
+    if (family->in_flight.size() >= max_echo_seq)
+    {
+        return false;
+    }
+
+    auto seq = family->echo_seq++;
+    while (family->in_flight.contains(seq))
+    {
+        seq = family->echo_seq++;
+    }
+
+    // Store probe in a free slot and queue it for sending.
+    auto slot = static_cast<std::uint32_t>(probes_.size());
+    if (free_slots_.empty())
+    {
+        probes_.emplace_back();
+    }
+    else
+    {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    }
+
+    auto& probe    = probes_[slot];
+    probe.id       = request.id;
+    probe.addr     = request.addr;
+    probe.start    = Clock::now();
+    probe.deadline = request.deadline;
+    probe.echo_seq     = seq;
+    probe.active       = true;
+    probe.send_pending = true;
+
+    family->in_flight.insert(seq, slot);
+    family->unsent.push_back(slot);
+    deadlines_.insert(Deadline(probe.deadline, slot));
+    return true;
+}
+
+bool IcmpProbeEngine::send_requests(Family& family)
+{
+    std::uint8_t  packets[probe_icmp_batch][icmp_echo_size];
+    iovec         iovs[probe_icmp_batch];
+    mmsghdr       msgs[probe_icmp_batch];
+    std::uint32_t slots[probe_icmp_batch];
+
+    auto sent = std::size_t(0);
+
+    while (sent < family.unsent.size())
+    {
+        // Assemble next batch. Probes might have expired before they were sent.
+        auto count = 0u;
+        auto next  = sent;
+
+        for (; (next < family.unsent.size()) && (count < probe_icmp_batch); ++next)
+        {
+            auto slot   = family.unsent[next];
+            auto& probe = probes_[slot];
+
+            // The slot was kept while it was queued, it is free now.
+            if (!probe.active)
+            {
+                probe.send_pending = false;
+                free_slots_.push_back(slot);
+                continue;
+            }
+
+            auto echo = IcmpEcho{family.echo_id, probe.echo_seq};
+            iovs[count].iov_base = packets[count];
+            iovs[count].iov_len  = make_echo_request(family.sock->family, echo, packets[count]);
+
+            std::memset(&msgs[count], 0, sizeof(msgs[count]));
+            msgs[count].msg_hdr.msg_name    = probe.addr.get();
+            msgs[count].msg_hdr.msg_namelen = probe.addr.length;
+            msgs[count].msg_hdr.msg_iov     = &iovs[count];
+            msgs[count].msg_hdr.msg_iovlen  = 1;
+
+            probe.start  = Clock::now();
+            slots[count] = slot;
+            ++count;
+        }
+
+        // Send batch. Requests the kernel refuses fail right away.
+        auto done = 0u;
+        while (done < count)
+        {
+            auto ret = ::sendmmsg(family.sock->fd.get(), &msgs[done], count - done, 0);
+            if (ret > 0)
+            {
+                for (auto i = done; i < (done + static_cast<unsigned>(ret)); ++i)
+                {
+                    probes_[slots[i]].send_pending = false;
+                }
+                done += static_cast<unsigned>(ret);
+            }
+            else if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == ENOBUFS))
+            {
+                // Socket buffer full. Keep the remaining requests for later.
+                auto left = std::vector<std::uint32_t>(slots + done, slots + count);
+                left.insert( left.end()
+                           , family.unsent.begin() + static_cast<std::ptrdiff_t>(next)
+                           , family.unsent.end()
+                           );
+                family.unsent.swap(left);
+                return false;
+            }
+            else if (errno != EINTR)
+            {
+                probes_[slots[done]].send_pending = false;
+                finish_probe(slots[done], false);
+                ++done;
+            }
+        }
+        sent = next;
+    }
+
+    family.unsent.clear();
+    return true;
+}
+
+void IcmpProbeEngine::receive_replies(Family& family)
+{
+    std::uint8_t     packets[probe_icmp_batch][max_packet_size];
+    sockaddr_storage addrs[probe_icmp_batch];
+    iovec            iovs[probe_icmp_batch];
+    mmsghdr          msgs[probe_icmp_batch];
+
+    while (true)
+    {
+        for (auto i = 0u; i < probe_icmp_batch; ++i)
+        {
+            iovs[i].iov_base = packets[i];
+            iovs[i].iov_len  = max_packet_size;
+
+            std::memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_name    = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            msgs[i].msg_hdr.msg_iov     = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen  = 1;
+        }
+
+        auto count = ::recvmmsg( family.sock->fd.get()
+                               , msgs
+                               , probe_icmp_batch
+                               , MSG_DONTWAIT
+                               , nullptr
+                               );
+        if (count <= 0)
+        {
+            return;
+        }
+
+        // Match replies to probes in flight. Raw sockets see any echo reply
+        // on this host, check identifier and origin as well.
+        for (auto i = 0; i < count; ++i)
+        {
+            auto echo = parse_echo_reply(family.sock.value(), packets[i], msgs[i].msg_len);
+            if (!echo || (echo->id != family.echo_id))
+            {
+                continue;
+            }
+
+            auto slot = family.in_flight.find(echo->seq);
+            if (!slot || !same_address(addrs[i], probes_[slot.value()].addr))
+            {
+                continue;
+            }
+            finish_probe(slot.value(), true);
+        }
+    }
+}
+
+void IcmpProbeEngine::finish_probe(std::uint32_t slot, bool available)
+{
+    auto& probe = probes_[slot];
+    auto rtt    = duration_cast<microseconds>(Clock::now() - probe.start);
+
+    get_family(probe.addr)->in_flight.erase(probe.echo_seq);
+    deadlines_.erase(Deadline(probe.deadline, slot));
+    probe.active = false;
+
+    // A slot still queued for sending is freed by send_requests(). Reusing
+    // it now would queue it twice.
+    if (!probe.send_pending)
+    {
+        free_slots_.push_back(slot);
+    }
+
+    completion_(probe.id, ProbeResult{available, rtt});
+}
+
+int IcmpProbeEngine::next_timeout() const
+{
+    if (deadlines_.empty())
+    {
+        return -1;
+    }
+
+    // Round up, waking up early would only spin.
+    auto left = duration_cast<milliseconds>(deadlines_.begin()->first - Clock::now());
+    if (left.count() < 0)
+    {
+        return 0;
+    }
+    return static_cast<int>(left.count()) + 1;
+}
+
+void IcmpProbeEngine::expire_probes()
+{
+    auto now = Clock::now();
+
+    while (!deadlines_.empty() && (deadlines_.begin()->first <= now))
+    {
+        finish_probe(deadlines_.begin()->second, false);
+    }
+}
@@ -0,0 +1,126 @@
+/**
+ * @file      IcmpProbeEngine.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Probe engine sharing one icmp socket per address family.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef ICMPPROBEENGINE_HPP_201812281530
+#define ICMPPROBEENGINE_HPP_201812281530
+
+#include <set>
+#include <deque>
+#include <array>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include "Icmp.hpp"
+#include "FlatHashMap.hpp"
+#include "FileDescriptor.hpp"
+#include "ProbeEngine.hpp"
+
+// Probes hosts with icmp echo requests. All probes of an address family share
+// a single socket. Requests are sent in batches with sendmmsg, replies are read
+// in batches with recvmmsg and matched to their probe by the echo sequence number.
+class IcmpProbeEngine : public ProbeEngine
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Constructor: @p completion is called for each finished probe.
+    explicit IcmpProbeEngine(Completion completion);
+
+    // Destructor: Stops the engine thread. Probes in flight are dropped.
+    virtual ~IcmpProbeEngine();
+
+    // ProbeEngine interface implementation. See ProbeEngine.hpp
+    virtual void submit(std::vector<ProbeRequest> const& requests) override;
+
+    // Disable Copy and Move Semantics
+    IcmpProbeEngine(IcmpProbeEngine const& other) = delete;
+    IcmpProbeEngine(IcmpProbeEngine&& other) = delete;
+    IcmpProbeEngine& operator = (IcmpProbeEngine const& other) = delete;
+    IcmpProbeEngine& operator = (IcmpProbeEngine&& other) = delete;
+
+private:
+    // Shared socket of an address family. Echo requests in flight are
+    // identified by their sequence number.
+    struct Family
+    {
+        std::optional<IcmpSocket>                   sock;
+        std::uint16_t                               echo_id  = 0;
+        std::uint16_t                               echo_seq = 0;
+        FlatHashMap<std::uint16_t, std::uint32_t>   in_flight;
+        std::vector<std::uint32_t>                  unsent;
+    };
+
+    // Echo request in flight. Slots of finished probes are reused once
+    // they are no longer queued for sending.
+    struct Probe
+    {
+        std::size_t       id = 0;
+        Address           addr;
+        Clock::time_point start;
+        Clock::time_point deadline;
+        std::uint16_t     echo_seq     = 0;
+        bool              active       = false;
+        bool              send_pending = false;
+    };
+
+    // Deadlines of all probes in flight, ordered by time.
+    using Deadline  = std::pair<Clock::time_point, std::uint32_t>;
+    using Deadlines = std::set<Deadline>;
+
+    // Engine thread: Sends submitted echo requests and waits for replies.
+    void run();
+
+    // Get family of @p addr. Returns nullptr for unsupported families.
+    Family* get_family(Address const& addr);
+
+    // Assign a slot and sequence number to @p request and queue it for sending.
+    // Returns false if no sequence number is available.
+    bool start_probe(ProbeRequest const& request);
+
+    // Send all queued echo requests of @p family. Returns false if the socket
+    // buffer is full and requests are left.
+    bool send_requests(Family& family);
+
+    // Read all pending echo replies of @p family.
+    void receive_replies(Family& family);
+
+    // Finish probe in @p slot and report the result.
+    void finish_probe(std::uint32_t slot, bool available);
+
+    // Get time in milliseconds until the next deadline, -1 if there is none.
+    int next_timeout() const;
+
+    // Finish all probes that exceeded their deadline.
+    void expire_probes();
+
+    Completion                 completion_;
+    FileDescriptor             epoll_;
+    FileDescriptor             event_;
+    std::array<Family, 2>      families_;
+    std::atomic_bool           running_;
+    std::thread                thread_;
+
+    // Submitted requests, filled by submit(), drained by the engine thread.
+    std::mutex                 mtx_;
+    std::vector<ProbeRequest>  submitted_;
+
+    // Owned by the engine thread.
+    std::vector<Probe>         probes_;
+    std::vector<std::uint32_t> free_slots_;
+    Deadlines                  deadlines_;
+    std::deque<ProbeRequest>   backlog_;
+};
+
+#endif // ICMPPROBEENGINE_HPP_201812281530
@@ -0,0 +1,222 @@
+/**
+ * @file      IoUring.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Minimal wrapper for linux io_uring instances.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "Util.hpp"
+#include "IoUring.hpp"
+
+namespace
+{
+// Get pointer at @p offset into mapping @p base.
+template<typename T>
+T* at_offset(void* base, std::uint32_t offset)
+{
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+// Map ring memory of @p fd at @p offset. Returns nullptr on failure.
+void* map_ring(int fd, std::size_t size, off_t offset)
+{
+    auto ptr = ::mmap( nullptr
+                     , size
+                     , PROT_READ | PROT_WRITE
+                     , MAP_SHARED | MAP_POPULATE
+                     , fd
+                     , offset
+                     );
+    return (ptr == MAP_FAILED) ? nullptr : ptr;
+}
+} // namespace anon
+
+IoUring::IoUring(unsigned entries)
+    : fd_()
+    , sq_ring_(nullptr)
+    , sq_ring_size_(0)
+    , cq_ring_(nullptr)
+    , cq_ring_size_(0)
+    , sqes_(nullptr)
+    , sqes_size_(0)
+    , sq_head_(nullptr)
+    , sq_tail_(nullptr)
+    , sq_mask_(0)
+    , sq_entries_(0)
+    , cq_head_(nullptr)
+    , cq_tail_(nullptr)
+    , cq_mask_(0)
+    , cqes_(nullptr)
+    , sqe_tail_(0)
+    , sqe_pending_(0)
+{
+    auto params = io_uring_params();
+    std::memset(&params, 0, sizeof(params));
+
+    fd_.reset(static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params)));
+    if (!fd_.is_valid())
+    {
+        return;
+    }
+
+    // Map submission and completion rings. Newer kernels share one mapping.
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(Cqe);
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        cq_ring_size_ = 0;
+    }
+
+    sq_ring_ = map_ring(fd_.get(), sq_ring_size_, IORING_OFF_SQ_RING);
+    cq_ring_ = (cq_ring_size_ == 0) ? sq_ring_
+                                    : map_ring(fd_.get(), cq_ring_size_, IORING_OFF_CQ_RING);
+
+    sqes_size_ = params.sq_entries * sizeof(Sqe);
+    sqes_      = static_cast<Sqe*>(map_ring(fd_.get(), sqes_size_, IORING_OFF_SQES));
+
+    if (!sq_ring_ || !cq_ring_ || !sqes_)
+    {
+        fd_.reset();
+        return;
+    }
+
+    sq_head_    = at_offset<unsigned>(sq_ring_, params.sq_off.head);
+    sq_tail_    = at_offset<unsigned>(sq_ring_, params.sq_off.tail);
+    sq_mask_    = *at_offset<unsigned>(sq_ring_, params.sq_off.ring_mask);
+    sq_entries_ = *at_offset<unsigned>(sq_ring_, params.sq_off.ring_entries);
+    cq_head_    = at_offset<unsigned>(cq_ring_, params.cq_off.head);
+    cq_tail_    = at_offset<unsigned>(cq_ring_, params.cq_off.tail);
+    cq_mask_    = *at_offset<unsigned>(cq_ring_, params.cq_off.ring_mask);
+    cqes_       = at_offset<Cqe>(cq_ring_, params.cq_off.cqes);
+
+    // Entries are always used in order. The index array maps them one to one.
+    auto array = at_offset<unsigned>(sq_ring_, params.sq_off.array);
+    for (auto i = 0u; i < sq_entries_; ++i)
+    {
+        array[i] = i;
+    }
+    sqe_tail_ = *sq_tail_;
+}
+
+IoUring::~IoUring()
+{
+    if (sqes_)
+    {
+        ::munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ && (cq_ring_ != sq_ring_))
+    {
+        ::munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_)
+    {
+        ::munmap(sq_ring_, sq_ring_size_);
+    }
+}
+
+bool IoUring::is_valid() const
+{
+    return fd_.is_valid();
+}
+
+bool IoUring::supports(std::initializer_list<std::uint8_t> ops) const
+{
+    if (!is_valid())
+    {
+        return false;
+    }
+
+    // Ask kernel for supported opcodes.
+    auto const op_count = std::size_t(256);
+    auto buf = std::vector<char>(sizeof(io_uring_probe) + op_count * sizeof(io_uring_probe_op), 0);
+    auto probe = reinterpret_cast<io_uring_probe*>(buf.data());
+
+    if (::syscall(__NR_io_uring_register, fd_.get(), IORING_REGISTER_PROBE, probe, op_count) < 0)
+    {
+        return false;
+    }
+
+    for (auto op : ops)
+    {
+        if ((op > probe->last_op) || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void IoUring::reserve(unsigned count)
+{
+    auto used = [this] { return sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE); };
+
+    // Not enough space: Hand everything queued to the kernel.
+    if (used() + count > sq_entries_)
+    {
+        submit();
+    }
+    if (used() + count > sq_entries_)
+    {
+        abort("Failed to submit io_uring entries");
+    }
+}
+
+IoUring::Sqe* IoUring::get_sqe()
+{
+    reserve(1);
+
+    auto sqe = &sqes_[sqe_tail_ & sq_mask_];
+    std::memset(sqe, 0, sizeof(*sqe));
+
+    sqe_tail_ += 1;
+    sqe_pending_ += 1;
+    return sqe;
+}
+
+void IoUring::submit(unsigned wait_nr)
+{
+    __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+
+    auto flags = (wait_nr > 0) ? unsigned(IORING_ENTER_GETEVENTS) : 0u;
+    auto ret   = ::syscall( __NR_io_uring_enter
+                          , fd_.get()
+                          , sqe_pending_
+                          , wait_nr
+                          , flags
+                          , nullptr
+                          , 0
+                          );
+
+    // Interrupted waits return early. The caller simply handles no completions.
+    if (ret >= 0)
+    {
+        sqe_pending_ -= std::min(sqe_pending_, static_cast<unsigned>(ret));
+    }
+}
+
+void IoUring::for_each_cqe(Handler const& handler)
+{
+    auto head = *cq_head_;
+    auto tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; ++head)
+    {
+        handler(cqes_[head & cq_mask_]);
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,92 @@
+/**
+ * @file      IoUring.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Minimal wrapper for linux io_uring instances.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef IOURING_HPP_201812291020
+#define IOURING_HPP_201812291020
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <linux/io_uring.h>
+#include "FileDescriptor.hpp"
+
+// Owns an io_uring instance and its mapped submission and completion queues.
+// Talks to the kernel via raw system calls, there is no dependency on liburing.
+// Not thread safe, meant to be used by a single thread.
+class IoUring
+{
+public:
+    using Sqe     = io_uring_sqe;
+    using Cqe     = io_uring_cqe;
+    using Handler = std::function<void(Cqe const&)>;
+
+    // Constructor: Setup ring with @p entries submission queue entries.
+    // Check is_valid() to see if the kernel supports io_uring.
+    explicit IoUring(unsigned entries);
+
+    ~IoUring();
+
+    // Check if the ring was setup successfully.
+    bool is_valid() const;
+
+    // Check if the kernel supports all opcodes in @p ops.
+    bool supports(std::initializer_list<std::uint8_t> ops) const;
+
+    // Make sure @p count submission queue entries are available. In case
+    // the queue is too full, all queued entries are submitted first.
+    // Entries linked together must be reserved at once.
+    void reserve(unsigned count);
+
+    // Get empty submission queue entry. See reserve().
+    Sqe* get_sqe();
+
+    // Submit queued entries and wait for at least @p wait_nr completions.
+    void submit(unsigned wait_nr = 0);
+
+    // Call @p handler for each available completion and consume it.
+    void for_each_cqe(Handler const& handler);
+
+    // Disable Copy and Move Semantics
+    IoUring(IoUring const& other) = delete;
+    IoUring(IoUring&& other) = delete;
+    IoUring& operator = (IoUring const& other) = delete;
+    IoUring& operator = (IoUring&& other) = delete;
+
+private:
+    FileDescriptor fd_;
+
+    // Mappings of the rings and submission queue entries
+    void*          sq_ring_;
+    std::size_t    sq_ring_size_;
+    void*          cq_ring_;
+    std::size_t    cq_ring_size_;
+    Sqe*           sqes_;
+    std::size_t    sqes_size_;
+
+    // Pointers into the mapped rings
+    unsigned*      sq_head_;
+    unsigned*      sq_tail_;
+    unsigned       sq_mask_;
+    unsigned       sq_entries_;
+    unsigned*      cq_head_;
+    unsigned*      cq_tail_;
+    unsigned       cq_mask_;
+    Cqe*           cqes_;
+
+    // Entries handed out by get_sqe() but not submitted yet.
+    unsigned       sqe_tail_;
+    unsigned       sqe_pending_;
+};
+
+#endif // IOURING_HPP_201812291020
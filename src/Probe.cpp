@@ -0,0 +1,100 @@
+/**
+ * @file      Probe.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Reachability probes.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <algorithm>
+#include "Util.hpp"
+#include "Constants.hpp"
+#include "Probe.hpp"
+
+namespace
+{
+// Get address family used by @p proto.
+int get_family(Protocol proto)
+{
+    switch (proto)
+    {
+        case Protocol::IcmpV4: return AF_INET;
+        case Protocol::IcmpV6: return AF_INET6;
+        default:            return AF_UNSPEC;
+    }
+}
+} // namespace anon
+
+ProbeTarget make_probe_target(ConfigHost const& host, StringArena const& strings)
+{
+    auto target = ProbeTarget();
+    target.protocol = host.protocol;
+    target.name     = Resolver::Name(strings.get(host.fqhn), get_family(host.protocol));
+    target.port     = host.port;
+
+    // Timeouts adapt to round trip times between a fixed minimum and max_timeout.
+    target.timeout     = std::chrono::milliseconds(probe_timeout_ms);
+    target.max_timeout = std::chrono::milliseconds(probe_max_timeout_ms);
+
+    if (host.timeout.count() != 0)
+    {
+        target.timeout     = host.timeout;
+        target.max_timeout = std::max(target.max_timeout, target.timeout);
+    }
+    if (host.max_timeout.count() != 0)
+    {
+        target.max_timeout = host.max_timeout;
+    }
+    return target;
+}
+
+ProbeInterval make_probe_interval(ConfigHost const& host)
+{
+    auto result = ProbeInterval{host.interval, host.interval, host.interval};
+
+    if (host.min_interval.count() != 0)
+    {
+        result.min = host.min_interval;
+    }
+    if (host.max_interval.count() != 0)
+    {
+        result.max = host.max_interval;
+    }
+    return result;
+}
+
+ProbeConfirm make_probe_confirm(ConfigGlobal const& global)
+{
+    auto confirm = ProbeConfirm{ probe_confirm_retries
+                               , std::chrono::milliseconds(probe_confirm_space_ms)
+                               };
+
+    confirm.retries = global.confirm_retries.value_or(confirm.retries);
+    confirm.spacing = global.confirm_spacing.value_or(confirm.spacing);
+    return confirm;
+}
+
+ProbeLimits make_probe_limits(ConfigGlobal const& global)
+{
+    auto limits = ProbeLimits{0, 0, true};
+
+    limits.rate        = global.rate_limit.value_or(limits.rate);
+    limits.subnet_rate = global.subnet_rate_limit.value_or(limits.subnet_rate);
+    limits.spread      = global.phase_spread.value_or(limits.spread);
+    return limits;
+}
+
+std::optional<Address> resolve_target(ProbeTarget const& target, Resolver& resolver)
+{
+    auto addr = resolver.lookup(target.name);
+    if (addr)
+    {
+        set_port(addr.value(), target.port);
+    }
+    return addr;
+}
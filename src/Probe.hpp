@@ -0,0 +1,98 @@
+/**
+ * @file      Probe.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Reachability probes.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef PROBE_HPP_201812271942
+#define PROBE_HPP_201812271942
+
+#include <memory>
+#include <string>
+#include <optional>
+#include <chrono>
+#include <cstdint>
+#include "Config.hpp"
+#include "Address.hpp"
+#include "Resolver.hpp"
+
+// Everything needed to probe a single host. The name to resolve is made
+// once, lookups of each probe use it as it is.
+struct ProbeTarget
+{
+    Protocol                         protocol;
+    Resolver::Name                   name;
+    std::uint16_t                    port;
+    std::chrono::milliseconds        timeout;
+    std::chrono::milliseconds        max_timeout;
+};
+
+// Time between probes. The interval adapts if min and max differ: It grows
+// towards max while the host is stable and drops to min on a state change.
+struct ProbeInterval
+{
+    std::chrono::seconds interval;
+    std::chrono::seconds min;
+    std::chrono::seconds max;
+};
+
+// Confirmation of state changes: A changed state is reported after
+// @p retries further probes, started @p spacing apart, confirmed it.
+struct ProbeConfirm
+{
+    unsigned                  retries;
+    std::chrono::milliseconds spacing;
+};
+
+// Limits of the probe load. Rates are probes per second, 0 is unlimited.
+// With @p spread, the first probes are spread across their interval.
+struct ProbeLimits
+{
+    unsigned rate;
+    unsigned subnet_rate;
+    bool     spread;
+};
+
+// Outcome of a single probe.
+struct ProbeResult
+{
+    bool                      available;
+    std::chrono::microseconds rtt;
+};
+
+// Interface for anything interested in probe results.
+class ProbeObserver
+{
+public:
+    using Pointer = std::shared_ptr<ProbeObserver>;
+
+    virtual ~ProbeObserver() = default;
+
+    // Called after each finished probe. Executed in the thread
+    // context of the probe scheduler.
+    virtual void probe_finished(ProbeResult const& result) = 0;
+};
+
+// Make probe target from host configuration, its text is in @p strings.
+ProbeTarget make_probe_target(ConfigHost const& host, StringArena const& strings);
+
+// Make probe interval from host configuration.
+ProbeInterval make_probe_interval(ConfigHost const& host);
+
+// Make confirmation policy from global configuration.
+ProbeConfirm make_probe_confirm(ConfigGlobal const& global);
+
+// Make probe limits from global configuration.
+ProbeLimits make_probe_limits(ConfigGlobal const& global);
+
+// Get cached address of @p target from @p resolver, including its port.
+std::optional<Address> resolve_target(ProbeTarget const& target, Resolver& resolver);
+
+#endif // PROBE_HPP_201812271942
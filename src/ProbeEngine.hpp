@@ -0,0 +1,47 @@
+/**
+ * @file      ProbeEngine.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Interface for asynchronous probe engines.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef PROBEENGINE_HPP_201812281104
+#define PROBEENGINE_HPP_201812281104
+
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include "Address.hpp"
+#include "Probe.hpp"
+
+// Single probe handed to a probe engine.
+struct ProbeRequest
+{
+    std::size_t                           id;
+    Protocol                              protocol;
+    Address                               addr;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+// Interface for engines executing many probes concurrently.
+class ProbeEngine
+{
+public:
+    // Called once per finished probe with the id of the request.
+    // Executed in the thread context of the engine.
+    using Completion = std::function<void(std::size_t id, ProbeResult const& result)>;
+
+    virtual ~ProbeEngine() = default;
+
+    // Start all probes in @p requests. Returns without waiting for results.
+    virtual void submit(std::vector<ProbeRequest> const& requests) = 0;
+};
+
+#endif // PROBEENGINE_HPP_201812281104
@@ -0,0 +1,482 @@
+/**
+ * @file      ProbeScheduler.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Central scheduler driving the probes of all hosts.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <algorithm>
+#include "Constants.hpp"
+#include "TcpProbeEngine.hpp"
+#include "IcmpProbeEngine.hpp"
+#include "UringProbeEngine.hpp"
+#include "ProbeScheduler.hpp"
+
+using namespace std::chrono;
+
+namespace
+{
+// Make factory of the engines of @p backend.
+ProbeScheduler::EngineFactory make_engine_factory(Backend backend)
+{
+    return [backend] (ProbeEngine::Completion completion)
+    {
+        if ((backend == Backend::IoUring) && UringProbeEngine::is_supported())
+        {
+            auto engine = std::make_shared<UringProbeEngine>(completion);
+            return ProbeScheduler::Engines(engine, engine);
+        }
+        return ProbeScheduler::Engines( std::make_shared<TcpProbeEngine>(completion)
+                                      , std::make_shared<IcmpProbeEngine>(completion)
+                                      );
+    };
+}
+} // namespace
+
+ProbeScheduler::ProbeScheduler( unsigned         worker_count
+                              , Backend          backend
+                              , Resolver::Lookup lookup
+                              , ProbeConfirm     confirm
+                              , ProbeLimits      limits
+                              )
+    : ProbeScheduler( worker_count
+                    , make_engine_factory(backend)
+                    , std::move(lookup)
+                    , confirm
+                    , limits
+                    )
+{
+}
+
+ProbeScheduler::ProbeScheduler( unsigned         worker_count
+                              , EngineFactory    make_engines
+                              , Resolver::Lookup lookup
+                              , ProbeConfirm     confirm
+                              , ProbeLimits      limits
+                              )
+    : added_()
+    , entries_()
+    , workers_()
+    , resolver_( probe_dns_threads
+               , seconds(probe_dns_ttl_s)
+               , seconds(probe_dns_retry_s)
+               , std::move(lookup)
+               )
+    , make_engines_(std::move(make_engines))
+    , confirm_(confirm)
+    , limits_(limits)
+    , tcp_engine_()
+    , icmp_engine_()
+    , timer_thread_()
+    , epoch_(Clock::now())
+    , running_(false)
+    , rate_bucket_()
+    , subnet_buckets_()
+    , prepaid_()
+    , schedule_mtx_()
+    , schedule_cv_()
+    , schedule_()
+{
+    for (auto i = 0u; i < std::max(worker_count, 1u); ++i)
+    {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+}
+
+ProbeScheduler::~ProbeScheduler()
+{
+    stop();
+}
+
+void ProbeScheduler::add_probe( ProbeTarget const&            target
+                              , ProbeInterval const&          interval
+                              , ProbeObserver::Pointer const& observer
+                              )
+{
+    // Never raise a configured timeout below the floor.
+    auto min_timeout = std::min(target.timeout, milliseconds(probe_min_timeout_ms));
+    added_.push_back(Entry{ target
+                          , interval
+                          , interval.interval
+                          , std::nullopt
+                          , 0
+                          , RttEstimator( target.timeout
+                                        , min_timeout
+                                        , target.max_timeout
+                                        )
+                          , {observer}
+                          , Clock::time_point()
+                          });
+}
+
+void ProbeScheduler::merge_probes()
+{
+    // Resolve all names at once, the resolver works on them in parallel.
+    auto names = std::vector<Resolver::Name>();
+    for (auto const& entry : added_)
+    {
+        names.push_back(entry.target.name);
+    }
+    resolver_.resolve(names);
+
+    // Names resolving to the same address are the same host. Names that
+    // can't be resolved right now are compared as they are.
+    auto keys = std::map<Key, Id>();
+    for (auto& entry : added_)
+    {
+        auto addr = resolve_target(entry.target, resolver_);
+        auto host = addr ? address_to_string(addr.value()) : entry.target.name.first;
+        auto key  = Key( entry.target.protocol
+                       , host
+                       , entry.target.port
+                       , entry.interval.interval.count()
+                       , entry.interval.min.count()
+                       , entry.interval.max.count()
+                       , entry.target.timeout.count()
+                       , entry.target.max_timeout.count()
+                       );
+
+        auto it = keys.find(key);
+        if (it != keys.end())
+        {
+            auto& observers = entries_[it->second].observers;
+            observers.insert(observers.end(), entry.observers.begin(), entry.observers.end());
+            continue;
+        }
+
+        keys.emplace(key, entries_.size());
+        entries_.push_back(std::move(entry));
+    }
+    added_.clear();
+}
+
+void ProbeScheduler::start()
+{
+    if (running_)
+    {
+        return;
+    }
+    merge_probes();
+
+    running_ = true;
+    epoch_   = Clock::now();
+
+    // Spread the first probes evenly across their interval. Otherwise all
+    // hosts are probed at once and again in lockstep with each interval.
+    for (auto id = Id(0); id < entries_.size(); ++id)
+    {
+        auto offset = milliseconds(0);
+        if (limits_.spread)
+        {
+            auto n = static_cast<milliseconds::rep>(entries_.size());
+            auto i = static_cast<milliseconds::rep>(id);
+            offset = duration_cast<milliseconds>(entries_[id].current) * i / n;
+        }
+        schedule_.push_back(Schedule(id, to_tick(epoch_ + offset)));
+    }
+
+    if (limits_.rate > 0)
+    {
+        rate_bucket_.emplace(limits_.rate, epoch_);
+    }
+    prepaid_.assign(entries_.size(), false);
+
+    auto completion = [this] (Id id, ProbeResult const& result)
+    {
+        finish_probe(id, result);
+    };
+    std::tie(tcp_engine_, icmp_engine_) = make_engines_(completion);
+
+    for (auto& worker : workers_)
+    {
+        auto w = worker.get();
+        worker->thread = std::thread([this, w] { run_worker(*w); });
+    }
+    timer_thread_ = std::thread([this] { run_timer(); });
+}
+
+void ProbeScheduler::stop()
+{
+    if (!running_)
+    {
+        return;
+    }
+    running_ = false;
+
+    // Wakeup all threads. Taking the locks prevents lost wakeups.
+    {
+        auto lock = std::lock_guard<std::mutex>(schedule_mtx_);
+        schedule_cv_.notify_all();
+    }
+    for (auto& worker : workers_)
+    {
+        auto lock = std::lock_guard<std::mutex>(worker->mtx);
+        worker->cv.notify_all();
+    }
+
+    timer_thread_.join();
+    for (auto& worker : workers_)
+    {
+        worker->thread.join();
+    }
+    tcp_engine_.reset();
+    icmp_engine_.reset();
+}
+
+ProbeScheduler::Tick ProbeScheduler::to_tick(Clock::time_point time_point) const
+{
+    auto elapsed = duration_cast<milliseconds>(time_point - epoch_).count();
+    return static_cast<Tick>(std::max(elapsed, decltype(elapsed)(0))) / probe_tick_ms;
+}
+
+void ProbeScheduler::run_timer()
+{
+    auto wheel   = TimerWheel(0);
+    auto pending = std::vector<Schedule>();
+    auto limited = std::vector<Schedule>();
+    auto due     = std::vector<std::vector<Id>>(workers_.size());
+
+    while (running_)
+    {
+        // Sleep until the next tick. Grab everything that needs to be rescheduled.
+        {
+            auto lock = std::unique_lock<std::mutex>(schedule_mtx_);
+            auto next = epoch_ + milliseconds((wheel.get_tick() + 1) * probe_tick_ms);
+            schedule_cv_.wait_until(lock, next, [this] { return !running_; });
+            pending.swap(schedule_);
+        }
+
+        for (auto const& [id, tick] : pending)
+        {
+            wheel.schedule(id, tick);
+        }
+        pending.clear();
+
+        // Distribute due probes among the workers. Probes exceeding a rate
+        // limit are delayed until their turn.
+        auto now = Clock::now();
+        wheel.advance(to_tick(now), [this, &due, &limited, now] (Id id)
+        {
+            auto delay = get_rate_delay(id, now);
+            if (delay > Clock::duration(0))
+            {
+                limited.push_back(Schedule(id, to_tick(now + delay)));
+                return;
+            }
+            due[id % due.size()].push_back(id);
+        });
+
+        for (auto const& [id, tick] : limited)
+        {
+            wheel.schedule(id, tick);
+        }
+        limited.clear();
+
+        for (auto i = std::size_t(0); i < due.size(); ++i)
+        {
+            if (due[i].empty())
+            {
+                continue;
+            }
+
+            auto& worker = *workers_[i];
+            auto lock = std::lock_guard<std::mutex>(worker.mtx);
+            worker.queue.insert(worker.queue.end(), due[i].begin(), due[i].end());
+            worker.cv.notify_one();
+            due[i].clear();
+        }
+    }
+}
+
+ProbeScheduler::Clock::duration ProbeScheduler::get_rate_delay(Id id, Clock::time_point now)
+{
+    // Delayed probes paid in advance
+    if (prepaid_[id])
+    {
+        prepaid_[id] = false;
+        return Clock::duration(0);
+    }
+
+    // Probes of unresolved targets don't send anything, they pass the subnet limit.
+    auto subnet_bucket = static_cast<TokenBucket*>(nullptr);
+    if (limits_.subnet_rate > 0)
+    {
+        auto addr = resolve_target(entries_[id].target, resolver_);
+        if (addr)
+        {
+            auto prefix = (addr->family() == AF_INET6) ? probe_subnet_prefix_v6
+                                                       : probe_subnet_prefix_v4;
+            auto subnet = get_subnet(addr.value(), prefix);
+            auto it     = subnet_buckets_.find(subnet);
+            if (it == subnet_buckets_.end())
+            {
+                it = subnet_buckets_.emplace(subnet, TokenBucket(limits_.subnet_rate, now)).first;
+            }
+
+            subnet_bucket = &it->second;
+        }
+    }
+
+    // Take tokens only if all limits pass
+    auto rate_ok   = !rate_bucket_ || rate_bucket_->is_available(now);
+    auto subnet_ok = !subnet_bucket || subnet_bucket->is_available(now);
+    if (rate_ok && subnet_ok)
+    {
+        if (rate_bucket_)
+        {
+            rate_bucket_->take();
+        }
+        if (subnet_bucket)
+        {
+            subnet_bucket->take();
+        }
+        return Clock::duration(0);
+    }
+
+    // Otherwise reserve the tokens and wait for the slowest bucket. A delayed
+    // probe is checked once, however many probes are waiting.
+    auto delay = Clock::duration(0);
+    if (rate_bucket_)
+    {
+        delay = std::max(delay, rate_bucket_->reserve());
+    }
+    if (subnet_bucket)
+    {
+        delay = std::max(delay, subnet_bucket->reserve());
+    }
+    prepaid_[id] = true;
+    return std::max(delay, Clock::duration(1));
+}
+
+void ProbeScheduler::run_worker(Worker& worker)
+{
+    auto batch         = std::vector<Id>();
+    auto tcp_requests  = std::vector<ProbeRequest>();
+    auto icmp_requests = std::vector<ProbeRequest>();
+
+    while (running_)
+    {
+        {
+            auto lock = std::unique_lock<std::mutex>(worker.mtx);
+            worker.cv.wait(lock, [this, &worker]
+                {
+                    return !running_ || !worker.queue.empty();
+                });
+            batch.swap(worker.queue);
+        }
+
+        // Resolve targets and sort probes by engine. Each engine gets all of them at once.
+        for (auto id : batch)
+        {
+            if (!running_)
+            {
+                return;
+            }
+
+            auto& entry = entries_[id];
+            entry.started = Clock::now();
+
+            auto addr = resolve_target(entry.target, resolver_);
+            if (!addr)
+            {
+                finish_probe(id, ProbeResult{false, microseconds(0)});
+                continue;
+            }
+
+            auto request = ProbeRequest{ id
+                                       , entry.target.protocol
+                                       , addr.value()
+                                       , entry.started + entry.rtt.get_timeout()
+                                       };
+            if (entry.target.protocol == Protocol::Tcp)
+            {
+                tcp_requests.push_back(request);
+            }
+            else
+            {
+                icmp_requests.push_back(request);
+            }
+        }
+        batch.clear();
+
+        if (!tcp_requests.empty())
+        {
+            tcp_engine_->submit(tcp_requests);
+            tcp_requests.clear();
+        }
+        if (!icmp_requests.empty())
+        {
+            icmp_engine_->submit(icmp_requests);
+            icmp_requests.clear();
+        }
+    }
+}
+
+void ProbeScheduler::adapt_interval(Entry& entry, bool available)
+{
+    // State changed: Probe often until the host settles. Stable: Back off
+    // step by step. Only one probe per entry is in flight, no locking needed.
+    if (entry.available && (entry.available.value() != available))
+    {
+        entry.current = entry.interval.min;
+    }
+    else if (entry.available)
+    {
+        entry.current = std::min(entry.current * 2, entry.interval.max);
+    }
+    entry.available = available;
+}
+
+void ProbeScheduler::finish_probe(Id id, ProbeResult const& result)
+{
+    auto& entry = entries_[id];
+    auto due    = Clock::time_point();
+
+    // Changed state: Retry soon. Observers are told once enough retries
+    // confirmed the change, a single lost packet doesn't flip the state.
+    auto changed = entry.available && (entry.available.value() != result.available);
+    auto confirm = changed && (entry.retries < confirm_.retries);
+
+    // Failed probes don't measure a round trip time, wait longer next time.
+    // Not while confirming, that would stretch the confirmation.
+    if (result.available)
+    {
+        entry.rtt.sample(result.rtt);
+    }
+    else if (!confirm && (entry.retries == 0))
+    {
+        entry.rtt.backoff();
+    }
+
+    if (confirm)
+    {
+        entry.retries += 1;
+        due = Clock::now() + confirm_.spacing;
+    }
+    else
+    {
+        for (auto const& observer : entry.observers)
+        {
+            observer->probe_finished(result);
+        }
+
+        // The next probe is due one interval after this probe started. A
+        // rejected change keeps the interval, a flapping host isn't probed
+        // less often.
+        if (changed || (entry.retries == 0))
+        {
+            adapt_interval(entry, result.available);
+        }
+        entry.retries = 0;
+        due = entry.started + entry.current;
+    }
+
+    auto lock = std::lock_guard<std::mutex>(schedule_mtx_);
+    schedule_.push_back(Schedule(id, to_tick(due)));
+}
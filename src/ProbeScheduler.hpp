@@ -0,0 +1,188 @@
+/**
+ * @file      ProbeScheduler.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Central scheduler driving the probes of all hosts.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef PROBESCHEDULER_HPP_201812271942
+#define PROBESCHEDULER_HPP_201812271942
+
+#include <map>
+#include <tuple>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <utility>
+#include <functional>
+#include "Config.hpp"
+#include "Probe.hpp"
+#include "TimerWheel.hpp"
+#include "ProbeEngine.hpp"
+#include "Resolver.hpp"
+#include "RttEstimator.hpp"
+#include "TokenBucket.hpp"
+
+// Schedules the probes of all hosts. A timer thread hands due probes from a
+// timer wheel to a fixed pool of workers, which pass them on in batches to the
+// probe engines. The number of threads doesn't depend on the number of hosts.
+class ProbeScheduler
+{
+public:
+    using Clock    = std::chrono::steady_clock;
+    using Interval = std::chrono::seconds;
+
+    // Engines executing tcp and icmp probes. Both may be the same engine.
+    using Engines       = std::pair<std::shared_ptr<ProbeEngine>, std::shared_ptr<ProbeEngine>>;
+    using EngineFactory = std::function<Engines(ProbeEngine::Completion)>;
+
+    // Constructor: @p worker_count is the number of threads preparing probes.
+    // @p backend selects the probe engines. Falls back to Backend::Epoll if
+    // the kernel doesn't support io_uring. Names are resolved with @p lookup.
+    // State changes are confirmed according to @p confirm. The probe load
+    // is bounded by @p limits.
+    ProbeScheduler( unsigned         worker_count
+                  , Backend          backend
+                  , Resolver::Lookup lookup
+                  , ProbeConfirm     confirm
+                  , ProbeLimits      limits
+                  );
+
+    // Constructor: Like above, the engines are made by @p make_engines
+    // when scheduling starts.
+    ProbeScheduler( unsigned         worker_count
+                  , EngineFactory    make_engines
+                  , Resolver::Lookup lookup
+                  , ProbeConfirm     confirm
+                  , ProbeLimits      limits
+                  );
+
+    // Destructor: Stops all threads.
+    ~ProbeScheduler();
+
+    // Add a probe of @p target, executed every @p interval. The result of each
+    // probe is reported to @p observer. Probes must be added before start().
+    void add_probe( ProbeTarget const&            target
+                  , ProbeInterval const&          interval
+                  , ProbeObserver::Pointer const& observer
+                  );
+
+    // Start scheduling. Waits until all names are resolved, then equal
+    // probes are merged. The first probes are spread across their interval
+    // or, if spreading is disabled, executed immediately.
+    void start();
+
+    // Stop scheduling and wait for all threads to finish.
+    void stop();
+
+    // Disable Copy and Move Semantics
+    ProbeScheduler(ProbeScheduler const& other) = delete;
+    ProbeScheduler(ProbeScheduler&& other) = delete;
+    ProbeScheduler& operator = (ProbeScheduler const& other) = delete;
+    ProbeScheduler& operator = (ProbeScheduler&& other) = delete;
+
+private:
+    using Id       = TimerWheel::Id;
+    using Tick     = TimerWheel::Tick;
+    using Schedule = std::pair<Id, Tick>;
+
+    // Identifies equal probes: Protocol, address, port, intervals and timeouts.
+    using Key = std::tuple< Protocol
+                          , std::string
+                          , std::uint16_t
+                          , Interval::rep
+                          , Interval::rep
+                          , Interval::rep
+                          , std::chrono::milliseconds::rep
+                          , std::chrono::milliseconds::rep
+                          >;
+
+    // Scheduled probe. Equal hosts share an entry, its results are reported
+    // to all of their observers. A changed state is reported once @p retries
+    // quick retries confirmed it. The timeout follows the round trip times.
+    struct Entry
+    {
+        ProbeTarget                         target;
+        ProbeInterval                       interval;
+        Interval                            current;
+        std::optional<bool>                 available;
+        unsigned                            retries;
+        RttEstimator                        rtt;
+        std::vector<ProbeObserver::Pointer> observers;
+        Clock::time_point                   started;
+    };
+
+    // Probe executing thread with its own queue of due probes.
+    struct Worker
+    {
+        std::thread             thread;
+        std::mutex              mtx;
+        std::condition_variable cv;
+        std::vector<Id>         queue;
+    };
+
+    // Resolve added probes and merge equal ones into a single entry.
+    void merge_probes();
+
+    // Get tick of @p time_point.
+    Tick to_tick(Clock::time_point time_point) const;
+
+    // Timer thread: Advances the timer wheel and dispatches due probes.
+    void run_timer();
+
+    // Check rate limits of probe @p id at @p now. Takes a token of each
+    // bucket of the probe and returns 0 if no limit is exceeded. Otherwise
+    // the tokens are reserved and the delay until they refilled is returned.
+    Clock::duration get_rate_delay(Id id, Clock::time_point now);
+
+    // Worker thread: Passes probes handed over by the timer thread to the engines.
+    void run_worker(Worker& worker);
+
+    // Adapt interval of @p entry to confirmed state @p available.
+    void adapt_interval(Entry& entry, bool available);
+
+    // Report @p result of probe @p id and schedule its next execution.
+    void finish_probe(Id id, ProbeResult const& result);
+
+    std::vector<Entry>                   added_;
+    std::vector<Entry>                   entries_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    // Cache of resolved addresses, probes never wait for name resolution.
+    Resolver                             resolver_;
+    EngineFactory                        make_engines_;
+    ProbeConfirm                         confirm_;
+    ProbeLimits                          limits_;
+
+    // With the io_uring backend a single engine executes both kinds of probes.
+    std::shared_ptr<ProbeEngine>         tcp_engine_;
+    std::shared_ptr<ProbeEngine>         icmp_engine_;
+    std::thread                          timer_thread_;
+    Clock::time_point                    epoch_;
+    std::atomic_bool                     running_;
+
+    // Rate limits in total and per subnet, owned by the timer thread.
+    // Probes exceeding a limit are delayed until their reserved tokens
+    // refilled, they pass without another check.
+    std::optional<TokenBucket>           rate_bucket_;
+    std::map<Subnet, TokenBucket>        subnet_buckets_;
+    std::vector<bool>                    prepaid_;
+
+    // Probes to (re)schedule, filled by the workers, drained by the timer thread.
+    std::mutex                           schedule_mtx_;
+    std::condition_variable              schedule_cv_;
+    std::vector<Schedule>                schedule_;
+};
+
+#endif // PROBESCHEDULER_HPP_201812271942
@@ -0,0 +1,276 @@
+/**
+ * @file      Resolver.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Asynchronous name resolution with a shared cache.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <memory>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include "Util.hpp"
+#include "Resolver.hpp"
+
+namespace
+{
+// Parse numeric ip address @p str. Returns an empty optional on failure.
+std::optional<Address> parse_address(std::string const& str)
+{
+    auto addr = Address();
+    std::memset(&addr.storage, 0, sizeof(addr.storage));
+
+    auto in = reinterpret_cast<sockaddr_in*>(&addr.storage);
+    if (::inet_pton(AF_INET, str.c_str(), &in->sin_addr) == 1)
+    {
+        in->sin_family = AF_INET;
+        addr.length    = sizeof(sockaddr_in);
+        return addr;
+    }
+
+    auto in6 = reinterpret_cast<sockaddr_in6*>(&addr.storage);
+    if (::inet_pton(AF_INET6, str.c_str(), &in6->sin6_addr) == 1)
+    {
+        in6->sin6_family = AF_INET6;
+        addr.length      = sizeof(sockaddr_in6);
+        return addr;
+    }
+    return {};
+}
+} // namespace anon
+
+Resolver::Resolver( unsigned thread_count
+                  , Ttl      ttl
+                  , Ttl      negative_ttl
+                  , Lookup   lookup
+                  )
+    : ttl_(ttl)
+    , negative_ttl_(negative_ttl)
+    , lookup_(std::move(lookup))
+    , running_(true)
+    , threads_()
+    , cache_mtx_()
+    , cache_()
+    , mtx_()
+    , cv_()
+    , resolved_cv_()
+    , queue_()
+    , queued_()
+    , refresh_()
+{
+    for (auto i = 0u; i < std::max(thread_count, 1u); ++i)
+    {
+        threads_.push_back(std::thread([this] { run(); }));
+    }
+}
+
+Resolver::~Resolver()
+{
+    running_ = false;
+    {
+        auto lock = std::lock_guard<std::mutex>(mtx_);
+        cv_.notify_all();
+        resolved_cv_.notify_all();
+    }
+
+    for (auto& thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+void Resolver::resolve(std::vector<Name> const& names)
+{
+    auto is_cached = [this] (Name const& name)
+    {
+        auto lock = std::shared_lock<std::shared_mutex>(cache_mtx_);
+        return cache_.count(name) > 0;
+    };
+
+    auto lock = std::unique_lock<std::mutex>(mtx_);
+    for (auto const& name : names)
+    {
+        if (!is_cached(name))
+        {
+            queue(name);
+        }
+    }
+
+    resolved_cv_.wait(lock, [this, &names, &is_cached]
+        {
+            return !running_ || std::all_of(names.begin(), names.end(), is_cached);
+        });
+}
+
+std::optional<Address> Resolver::lookup(Name const& name)
+{
+    {
+        auto lock = std::shared_lock<std::shared_mutex>(cache_mtx_);
+        auto it   = cache_.find(name);
+        if (it != cache_.end())
+        {
+            // Known names are refreshed in the background
+            auto const& record = it->second;
+            if (record.expires > Clock::now())
+            {
+                return record.addr;
+            }
+        }
+    }
+
+    // Unknown and expired names are resolved right away
+    auto lock = std::lock_guard<std::mutex>(mtx_);
+    queue(name);
+    return {};
+}
+
+void Resolver::run()
+{
+    auto lock = std::unique_lock<std::mutex>(mtx_);
+
+    while (running_)
+    {
+        // Resolve queued names first. The lock is released while resolving.
+        if (!queue_.empty())
+        {
+            auto name = queue_.front();
+            queue_.pop_front();
+
+            lock.unlock();
+            auto addr = lookup_(name.first, name.second);
+            lock.lock();
+
+            store(name, addr);
+            continue;
+        }
+
+        // Queue records due for a refresh
+        if (!refresh_.empty() && (refresh_.begin()->first <= Clock::now()))
+        {
+            auto name = refresh_.begin()->second;
+            refresh_.erase(refresh_.begin());
+            queue(name);
+            continue;
+        }
+
+        if (refresh_.empty())
+        {
+            cv_.wait(lock);
+        }
+        else
+        {
+            // Copy the time, the record may be erased while waiting.
+            auto next = refresh_.begin()->first;
+            cv_.wait_until(lock, next);
+        }
+    }
+}
+
+void Resolver::queue(Name const& name)
+{
+    if (queued_.insert(name).second)
+    {
+        queue_.push_back(name);
+        cv_.notify_one();
+    }
+}
+
+void Resolver::store(Name const& name, std::optional<Address> const& addr)
+{
+    auto now      = Clock::now();
+    auto next     = now + negative_ttl_;
+    auto previous = Clock::time_point();
+
+    {
+        auto lock    = std::lock_guard<std::shared_mutex>(cache_mtx_);
+        auto& record = cache_[name];
+
+        // Refresh addresses ahead of their expiry. A failed refresh keeps
+        // the previous address until it expires.
+        if (addr)
+        {
+            record.addr    = addr;
+            record.expires = now + ttl_;
+            next           = now + Clock::duration(ttl_) * 4 / 5;
+        }
+        else if (!record.addr || (record.expires <= now))
+        {
+            record.addr.reset();
+            record.expires = now + negative_ttl_;
+        }
+
+        previous       = record.refresh;
+        record.refresh = next;
+    }
+
+    // Replace an earlier refresh, lookups may have queued the name before it.
+    queued_.erase(name);
+    refresh_.erase(Refresh(previous, name));
+    refresh_.insert(Refresh(next, name));
+    resolved_cv_.notify_all();
+}
+
+Resolver::Lookup make_hosts_file_lookup(std::string const& path)
+{
+    auto ifs = std::ifstream(path.c_str(), std::ifstream::in);
+    if (!ifs.is_open())
+    {
+        auto msg = std::string("Can't open hosts file '") + path + "'";
+        abort(msg);
+    }
+
+    // Each line holds an address followed by its names. '#' starts a comment.
+    auto hosts = std::make_shared<std::multimap<std::string, Address>>();
+    auto line  = std::string();
+
+    while (std::getline(ifs, line))
+    {
+        auto iss  = std::istringstream(line.substr(0, line.find('#')));
+        auto word = std::string();
+
+        if (!(iss >> word))
+        {
+            continue;
+        }
+
+        auto addr = parse_address(word);
+        if (!addr)
+        {
+            continue;
+        }
+
+        while (iss >> word)
+        {
+            hosts->emplace(word, addr.value());
+        }
+    }
+
+    return [hosts] (std::string const& fqhn, int family) -> std::optional<Address>
+    {
+        // Addresses are resolved as well, like the system resolver does.
+        auto addr = parse_address(fqhn);
+        if (addr && ((family == AF_UNSPEC) || (addr->family() == family)))
+        {
+            return addr;
+        }
+
+        auto range = hosts->equal_range(fqhn);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if ((family == AF_UNSPEC) || (it->second.family() == family))
+            {
+                return it->second;
+            }
+        }
+        return {};
+    };
+}
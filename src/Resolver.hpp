@@ -0,0 +1,111 @@
+/**
+ * @file      Resolver.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Asynchronous name resolution with a shared cache.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef RESOLVER_HPP_201812301104
+#define RESOLVER_HPP_201812301104
+
+#include <set>
+#include <map>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <utility>
+#include <optional>
+#include <functional>
+#include "Address.hpp"
+
+// Resolves names on a pool of threads and caches the results. Cached addresses
+// are resolved again in the background before they expire, lookups never block.
+// Names that can't be resolved are cached as well and retried after a shorter time.
+class Resolver
+{
+public:
+    using Clock  = std::chrono::steady_clock;
+    using Ttl    = std::chrono::seconds;
+    using Name   = std::pair<std::string, int>;
+    using Lookup = std::function<std::optional<Address>(std::string const& fqhn, int family)>;
+
+    // Constructor: Resolve names on @p thread_count threads with @p lookup.
+    // Addresses are cached for @p ttl, failed resolutions for @p negative_ttl.
+    Resolver( unsigned thread_count
+            , Ttl      ttl
+            , Ttl      negative_ttl
+            , Lookup   lookup
+            );
+
+    // Destructor: Stops all threads.
+    ~Resolver();
+
+    // Resolve all @p names in parallel and wait until they are cached.
+    void resolve(std::vector<Name> const& names);
+
+    // Get cached address of @p name. Unknown names are resolved
+    // in the background, until then an empty optional is returned.
+    std::optional<Address> lookup(Name const& name);
+
+    // Disable Copy and Move Semantics
+    Resolver(Resolver const& other) = delete;
+    Resolver(Resolver&& other) = delete;
+    Resolver& operator = (Resolver const& other) = delete;
+    Resolver& operator = (Resolver&& other) = delete;
+
+private:
+    // Cached resolution of a name and its entry in refresh_.
+    struct Record
+    {
+        std::optional<Address> addr;
+        Clock::time_point      expires;
+        Clock::time_point      refresh;
+    };
+
+    using Refresh = std::pair<Clock::time_point, Name>;
+
+    // Resolver thread: Resolves queued names and refreshes due records.
+    void run();
+
+    // Queue @p name for resolution. Expects mtx_ to be locked.
+    void queue(Name const& name);
+
+    // Store result @p addr of @p name and schedule its refresh.
+    void store(Name const& name, std::optional<Address> const& addr);
+
+    Ttl                      ttl_;
+    Ttl                      negative_ttl_;
+    Lookup                   lookup_;
+    std::atomic_bool         running_;
+    std::vector<std::thread> threads_;
+
+    // Cache, read by lookup(), written by the resolver threads.
+    std::shared_mutex        cache_mtx_;
+    std::map<Name, Record>   cache_;
+
+    // Names to resolve and refresh times of all cached names.
+    std::mutex               mtx_;
+    std::condition_variable  cv_;
+    std::condition_variable  resolved_cv_;
+    std::deque<Name>         queue_;
+    std::set<Name>           queued_;
+    std::set<Refresh>        refresh_;
+};
+
+// Make lookup reading addresses from an /etc/hosts style file at @p path
+// instead of asking the system resolver.
+Resolver::Lookup make_hosts_file_lookup(std::string const& path);
+
+#endif // RESOLVER_HPP_201812301104
@@ -0,0 +1,54 @@
+/**
+ * @file      RttEstimator.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Round trip time based probe timeouts.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <algorithm>
+#include "RttEstimator.hpp"
+
+RttEstimator::RttEstimator(Duration initial, Duration min, Duration max)
+    : min_(min)
+    , max_(std::max(min, max))
+    , srtt_(0)
+    , rttvar_(0)
+    , timeout_(std::clamp(initial, min_, max_))
+    , measured_(false)
+{
+}
+
+void RttEstimator::sample(Duration rtt)
+{
+    // First measurement initializes the estimator, afterwards
+    // the averages are updated with gains of 1/8 and 1/4.
+    if (!measured_)
+    {
+        srtt_     = rtt;
+        rttvar_   = rtt / 2;
+        measured_ = true;
+    }
+    else
+    {
+        auto delta = (srtt_ > rtt) ? (srtt_ - rtt) : (rtt - srtt_);
+        rttvar_    = (rttvar_ * 3 + delta) / 4;
+        srtt_      = (srtt_ * 7 + rtt) / 8;
+    }
+    timeout_ = std::clamp(srtt_ + rttvar_ * 4, min_, max_);
+}
+
+void RttEstimator::backoff()
+{
+    timeout_ = std::min(timeout_ * 2, max_);
+}
+
+RttEstimator::Duration RttEstimator::get_timeout() const
+{
+    return timeout_;
+}
@@ -0,0 +1,50 @@
+/**
+ * @file      RttEstimator.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Round trip time based probe timeouts.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef RTTESTIMATOR_HPP_201812301530
+#define RTTESTIMATOR_HPP_201812301530
+
+#include <chrono>
+
+// Derives a probe timeout from measured round trip times, like the
+// retransmission timeout of TCP (RFC 6298): The timeout is the smoothed
+// round trip time plus four times its variation. Each failed probe doubles
+// the timeout until the next round trip time is measured.
+class RttEstimator
+{
+public:
+    using Duration = std::chrono::microseconds;
+
+    // Constructor: @p initial is used until a round trip time is known.
+    // All timeouts are kept within [@p min, @p max].
+    RttEstimator(Duration initial, Duration min, Duration max);
+
+    // Add round trip time @p rtt of a successful probe.
+    void sample(Duration rtt);
+
+    // Back off after a failed probe.
+    void backoff();
+
+    // Get timeout of the next probe.
+    Duration get_timeout() const;
+
+private:
+    Duration min_;
+    Duration max_;
+    Duration srtt_;
+    Duration rttvar_;
+    Duration timeout_;
+    bool     measured_;
+};
+
+#endif // RTTESTIMATOR_HPP_201812301530
@@ -0,0 +1,107 @@
+/**
+ * @file      RttHistogram.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Log-bucketed round trip time histogram.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <algorithm>
+#include "RttHistogram.hpp"
+
+namespace
+{
+// Get bucket of @p value. Values below sub_count have a bucket each, above the
+// bucket is selected by the highest set bit and the sub_bits bits below it.
+unsigned to_bucket(std::uint64_t value)
+{
+    if (value < RttHistogram::sub_count)
+    {
+        return static_cast<unsigned>(value);
+    }
+
+    auto msb = 63u - static_cast<unsigned>(__builtin_clzll(value));
+    if (msb >= RttHistogram::max_bits)
+    {
+        return RttHistogram::bucket_count - 1;
+    }
+
+    auto shift = msb - RttHistogram::sub_bits;
+    auto sub   = static_cast<unsigned>(value >> shift) - RttHistogram::sub_count;
+    return (shift + 1) * RttHistogram::sub_count + sub;
+}
+
+// Get the middle of the value range covered by @p bucket.
+std::uint64_t from_bucket(unsigned bucket)
+{
+    if (bucket < RttHistogram::sub_count)
+    {
+        return bucket;
+    }
+
+    auto shift = bucket / RttHistogram::sub_count - 1;
+    auto sub   = bucket % RttHistogram::sub_count;
+    auto lower = std::uint64_t(RttHistogram::sub_count + sub) << shift;
+    return lower + ((std::uint64_t(1) << shift) >> 1);
+}
+} // anon namespace
+
+RttHistogram::RttHistogram()
+    : buckets_()
+    , count_(0)
+{
+    for (auto& bucket : buckets_)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void RttHistogram::record(Duration rtt)
+{
+    auto value = static_cast<std::uint64_t>(std::max(rtt.count(), Duration::rep(0)));
+
+    buckets_[to_bucket(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+RttHistogram::Duration RttHistogram::get_percentile(unsigned percent) const
+{
+    // Buckets are read one by one while samples are added. Aim for the
+    // rank within the count, but stop at the last filled bucket.
+    auto count = std::uint64_t(count_.load(std::memory_order_relaxed));
+    auto rank  = std::max((count * std::min(percent, 100u) + 99) / 100, std::uint64_t(1));
+    auto seen  = std::uint64_t(0);
+    auto last  = std::uint64_t(0);
+
+    if (count == 0)
+    {
+        return Duration(0);
+    }
+
+    for (auto i = 0u; i < bucket_count; ++i)
+    {
+        auto n = buckets_[i].load(std::memory_order_relaxed);
+        if (n == 0)
+        {
+            continue;
+        }
+
+        last  = from_bucket(i);
+        seen += n;
+        if (seen >= rank)
+        {
+            break;
+        }
+    }
+    return Duration(static_cast<Duration::rep>(last));
+}
+
+bool RttHistogram::is_measured() const
+{
+    return count_.load(std::memory_order_relaxed) != 0;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file      RttHistogram.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Log-bucketed round trip time histogram.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef RTTHISTOGRAM_HPP_201812311342
+#define RTTHISTOGRAM_HPP_201812311342
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+// Histogram of round trip times with logarithmic buckets (HDR-style): Each power
+// of two is split into sub_count linear buckets, a value is off by at most 1/sub_count.
+// Has a fixed size, regardless of the number of samples. Samples are recorded
+// with atomic increments from any thread, reading doesn't lock.
+class RttHistogram
+{
+public:
+    using Pointer  = std::shared_ptr<RttHistogram>;
+    using Duration = std::chrono::microseconds;
+
+    // Number of buckets. Round trip times beyond 2^max_bits us
+    // (about 33 s) are counted in the last bucket.
+    static unsigned const sub_bits     = 2;
+    static unsigned const sub_count    = 1u << sub_bits;
+    static unsigned const max_bits     = 25;
+    static unsigned const bucket_count = (max_bits - sub_bits + 1) * sub_count;
+
+    RttHistogram();
+
+    // Add round trip time @p rtt of a successful probe.
+    void record(Duration rtt);
+
+    // Get the round trip time @p percent of the samples are less or equal to.
+    // Zero if there are no samples.
+    Duration get_percentile(unsigned percent) const;
+
+    // Returns true if at least one sample was recorded.
+    bool is_measured() const;
+
+private:
+    using Counter = std::atomic<std::uint32_t>;
+
+    std::array<Counter, bucket_count> buckets_;
+    Counter                           count_;
+};
+
+#endif // RTTHISTOGRAM_HPP_201812311342
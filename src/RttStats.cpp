@@ -0,0 +1,98 @@
+/**
+ * @file      RttStats.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Lock-free round trip time statistics.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <algorithm>
+#include "RttStats.hpp"
+
+namespace
+{
+RttStats::Duration to_duration(std::uint64_t value)
+{
+    return RttStats::Duration(static_cast<RttStats::Duration::rep>(value));
+}
+} // anon namespace
+
+RttStats::RttStats()
+    : last_(0)
+    , min_(0)
+    , max_(0)
+    , sum_(0)
+    , count_(0)
+    , jitter_(0)
+{
+}
+
+void RttStats::sample(Duration rtt)
+{
+    // There is a single writer: Plain loads and stores are enough,
+    // no compare and swap loops needed.
+    auto value = static_cast<std::uint64_t>(std::max(rtt.count(), Duration::rep(0)));
+    auto count = count_.load(std::memory_order_relaxed);
+    auto last  = last_.load(std::memory_order_relaxed);
+
+    if (count == 0)
+    {
+        min_.store(value, std::memory_order_relaxed);
+        max_.store(value, std::memory_order_relaxed);
+    }
+    else
+    {
+        min_.store(std::min(min_.load(std::memory_order_relaxed), value), std::memory_order_relaxed);
+        max_.store(std::max(max_.load(std::memory_order_relaxed), value), std::memory_order_relaxed);
+
+        // Jitter: J += (|D| - J) / 16, with D the difference of consecutive samples
+        auto diff   = (value > last) ? (value - last) : (last - value);
+        auto jitter = jitter_.load(std::memory_order_relaxed);
+        jitter_.store((diff > jitter) ? (jitter + (diff - jitter) / 16)
+                                      : (jitter - (jitter - diff) / 16)
+                     , std::memory_order_relaxed);
+    }
+
+    last_.store(value, std::memory_order_relaxed);
+    sum_.store(sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+
+    // Publish the sample. Readers seeing the new count see the values above.
+    count_.store(count + 1, std::memory_order_release);
+}
+
+bool RttStats::is_measured() const
+{
+    return count_.load(std::memory_order_acquire) != 0;
+}
+
+RttStats::Duration RttStats::get_last() const
+{
+    return to_duration(last_.load(std::memory_order_relaxed));
+}
+
+RttStats::Duration RttStats::get_min() const
+{
+    return to_duration(min_.load(std::memory_order_relaxed));
+}
+
+RttStats::Duration RttStats::get_avg() const
+{
+    auto count = count_.load(std::memory_order_acquire);
+    auto sum   = sum_.load(std::memory_order_relaxed);
+    return to_duration((count != 0) ? (sum / count) : 0);
+}
+
+RttStats::Duration RttStats::get_max() const
+{
+    return to_duration(max_.load(std::memory_order_relaxed));
+}
+
+RttStats::Duration RttStats::get_jitter() const
+{
+    return to_duration(jitter_.load(std::memory_order_relaxed));
+}
@@ -0,0 +1,54 @@
+/**
+ * @file      RttStats.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Lock-free round trip time statistics.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef RTTSTATS_HPP_201812311004
+#define RTTSTATS_HPP_201812311004
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Round trip time statistics of a single host: Last, minimum, average and
+// maximum round trip time and the jitter (RFC 3550). Written by one thread at
+// a time, read concurrently without locking. Readers may see values of two
+// consecutive samples mixed.
+class RttStats
+{
+public:
+    using Duration = std::chrono::microseconds;
+
+    RttStats();
+
+    // Add round trip time @p rtt of a successful probe.
+    void sample(Duration rtt);
+
+    // Get statistics. All are zero until a sample was added.
+    bool is_measured() const;
+    Duration get_last() const;
+    Duration get_min() const;
+    Duration get_avg() const;
+    Duration get_max() const;
+    Duration get_jitter() const;
+
+private:
+    using Value = std::atomic<std::uint64_t>;
+
+    Value last_;
+    Value min_;
+    Value max_;
+    Value sum_;
+    Value count_;
+    Value jitter_;
+};
+
+#endif // RTTSTATS_HPP_201812311004
@@ -0,0 +1,102 @@
+/**
+ * @file      StringArena.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Interned strings in a single buffer.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <functional>
+#include <limits>
+#include "Util.hpp"
+#include "StringArena.hpp"
+
+StringArena::StringArena()
+    : text_()
+    , entries_(1, Entry{0, 0})
+    , index_(16, empty)
+{
+}
+
+StringArena::Id StringArena::intern(std::string_view const& str)
+{
+    if (str.empty())
+    {
+        return empty;
+    }
+
+    // Keep load factor below 1/2, probe sequences stay short.
+    if (2 * entries_.size() > index_.size())
+    {
+        rehash(2 * index_.size());
+    }
+
+    auto mask = index_.size() - 1;
+    auto pos  = index_of(str);
+    for (; index_[pos] != empty; pos = (pos + 1) & mask)
+    {
+        if (get(index_[pos]) == str)
+        {
+            return index_[pos];
+        }
+    }
+
+    // Ids and offsets are 32 bit. Configs are far from that.
+    if ((entries_.size() >= std::numeric_limits<Id>::max()) ||
+        ((text_.size() + str.size()) > std::numeric_limits<std::uint32_t>::max()))
+    {
+        abort("String arena is full");
+    }
+
+    auto id = static_cast<Id>(entries_.size());
+    entries_.push_back(Entry{ static_cast<std::uint32_t>(text_.size())
+                            , static_cast<std::uint32_t>(str.size())
+                            });
+    text_.append(str);
+    index_[pos] = id;
+    return id;
+}
+
+std::string_view StringArena::get(Id id) const
+{
+    auto const& entry = entries_[id];
+    return std::string_view(text_.data() + entry.offset, entry.len);
+}
+
+std::size_t StringArena::size() const
+{
+    return entries_.size();
+}
+
+std::size_t StringArena::get_memory() const
+{
+    return text_.capacity()
+         + entries_.capacity() * sizeof(Entry)
+         + index_.capacity() * sizeof(Id);
+}
+
+std::size_t StringArena::index_of(std::string_view const& str) const
+{
+    return std::hash<std::string_view>()(str) & (index_.size() - 1);
+}
+
+void StringArena::rehash(std::size_t capacity)
+{
+    index_.assign(capacity, empty);
+
+    auto mask = index_.size() - 1;
+    for (auto id = Id(1); id < entries_.size(); ++id)
+    {
+        auto pos = index_of(get(id));
+        while (index_[pos] != empty)
+        {
+            pos = (pos + 1) & mask;
+        }
+        index_[pos] = id;
+    }
+}
@@ -0,0 +1,70 @@
+/**
+ * @file      StringArena.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Interned strings in a single buffer.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef STRINGARENA_HPP_201901031015
+#define STRINGARENA_HPP_201901031015
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+// Stores each distinct string once, all of them in a single buffer. A string
+// is referred to by a compact id. Strings are never removed. Lookups go
+// through an open addressing index of ids, compared by content.
+class StringArena
+{
+public:
+    using Id = std::uint32_t;
+
+    // Id of the empty string. Used for optional strings that are not set.
+    static constexpr Id empty = 0;
+
+    // Constructor: Contains only the empty string.
+    StringArena();
+
+    // Get id of @p str, add it if it is not stored yet.
+    Id intern(std::string_view const& str);
+
+    // Get string of @p id. The view is valid until the next intern().
+    std::string_view get(Id id) const;
+
+    // Get number of distinct strings, including the empty string.
+    std::size_t size() const;
+
+    // Get number of bytes allocated for strings, ids and the index.
+    std::size_t get_memory() const;
+
+private:
+    // Location of a string in the buffer.
+    struct Entry
+    {
+        std::uint32_t offset;
+        std::uint32_t len;
+    };
+
+    // Get first bucket of @p str in the index.
+    std::size_t index_of(std::string_view const& str) const;
+
+    // Rebuild index with @p capacity buckets.
+    void rehash(std::size_t capacity);
+
+    std::string        text_;
+    std::vector<Entry> entries_;
+
+    // Buckets hold ids, the empty string marks a free bucket.
+    std::vector<Id>    index_;
+};
+
+#endif // STRINGARENA_HPP_201901031015
@@ -0,0 +1,250 @@
+/**
+ * @file      TcpProbeEngine.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Probe engine based on non-blocking tcp connects.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <cerrno>
+#include <limits>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "Constants.hpp"
+#include "Util.hpp"
+#include "TcpProbeEngine.hpp"
+
+using namespace std::chrono;
+
+namespace
+{
+// Epoll token of the eventfd signaling new submissions.
+std::uint64_t const event_token = std::numeric_limits<std::uint64_t>::max();
+} // namespace anon
+
+TcpProbeEngine::TcpProbeEngine(Completion completion)
+    : completion_(std::move(completion))
+    , epoll_(::epoll_create1(EPOLL_CLOEXEC))
+    , event_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    , running_(true)
+    , thread_()
+    , mtx_()
+    , submitted_()
+    , probes_()
+    , free_slots_()
+    , deadlines_()
+    , backlog_()
+{
+    if (!epoll_.is_valid() || !event_.is_valid())
+    {
+        abort("Failed to setup tcp probe engine");
+    }
+
+    auto ev = epoll_event();
+    ev.events   = EPOLLIN;
+    ev.data.u64 = event_token;
+    ::epoll_ctl(epoll_.get(), EPOLL_CTL_ADD, event_.get(), &ev);
+
+    // Each connect in flight needs its own socket.
+    raise_file_limit();
+    thread_ = std::thread([this] { run(); });
+}
+
+TcpProbeEngine::~TcpProbeEngine()
+{
+    running_ = false;
+    signal_event(event_.get());
+    thread_.join();
+}
+
+void TcpProbeEngine::submit(std::vector<ProbeRequest> const& requests)
+{
+    {
+        auto lock = std::lock_guard<std::mutex>(mtx_);
+        submitted_.insert(submitted_.end(), requests.begin(), requests.end());
+    }
+
+    // Wakeup engine thread
+    signal_event(event_.get());
+}
+
+void TcpProbeEngine::run()
+{
+    auto events    = std::vector<epoll_event>(probe_epoll_batch);
+    auto submitted = std::vector<ProbeRequest>();
+    auto blocked   = false;
+
+    while (running_)
+    {
+        // Don't sleep while there are connects waiting to be started.
+        auto timeout = (!backlog_.empty() && !blocked) ? 0 : next_timeout();
+        auto count   = ::epoll_wait( epoll_.get()
+                                   , events.data()
+                                   , static_cast<int>(events.size())
+                                   , timeout
+                                   );
+
+        for (auto i = 0; i < count; ++i)
+        {
+            auto token = events[i].data.u64;
+
+            // New submissions: Queue them behind earlier ones.
+            if (token == event_token)
+            {
+                clear_event(event_.get());
+                {
+                    auto lock = std::lock_guard<std::mutex>(mtx_);
+                    submitted.swap(submitted_);
+                }
+                backlog_.insert(backlog_.end(), submitted.begin(), submitted.end());
+                submitted.clear();
+                continue;
+            }
+
+            // Connect completed. The token is the slot of the probe.
+            auto slot   = static_cast<std::uint32_t>(token);
+            auto& probe = probes_[slot];
+
+            if (!probe.fd.is_valid())
+            {
+                continue;
+            }
+
+            auto error     = 0;
+            auto error_len = socklen_t(sizeof(error));
+            ::getsockopt(probe.fd.get(), SOL_SOCKET, SO_ERROR, &error, &error_len);
+            finish_probe(slot, error == 0);
+            blocked = false;
+        }
+
+        // Completions are handled first, a connect finishing right
+        // before its deadline must not be reported as unavailable.
+        if (expire_probes() > 0)
+        {
+            blocked = false;
+        }
+
+        // Start connects in portions, completions are handled in between.
+        for (auto started = 0u; !backlog_.empty() && (started < probe_connect_batch); ++started)
+        {
+            auto const& request = backlog_.front();
+
+            if (request.deadline <= Clock::now())
+            {
+                completion_(request.id, ProbeResult{false, microseconds(0)});
+            }
+            else if (!start_probe(request))
+            {
+                blocked = true;
+                break;
+            }
+            backlog_.pop_front();
+        }
+    }
+}
+
+bool TcpProbeEngine::start_probe(ProbeRequest const& request)
+{
+    auto start = Clock::now();
+    auto fd    = FileDescriptor(::socket( request.addr.family()
+                                        , SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC
+                                        , 0
+                                        ));
+    if (!fd.is_valid())
+    {
+        // Out of descriptors: Retry as soon as a connect in flight finishes.
+        auto in_flight = probes_.size() - free_slots_.size();
+        if (((errno == EMFILE) || (errno == ENFILE)) && (in_flight > 0))
+        {
+            return false;
+        }
+        completion_(request.id, ProbeResult{false, microseconds(0)});
+        return true;
+    }
+
+    if (::connect(fd.get(), request.addr.get(), request.addr.length) == 0)
+    {
+        auto rtt = duration_cast<microseconds>(Clock::now() - start);
+        completion_(request.id, ProbeResult{true, rtt});
+        return true;
+    }
+    if (errno != EINPROGRESS)
+    {
+        completion_(request.id, ProbeResult{false, microseconds(0)});
+        return true;
+    }
+
+    // Connect in flight. Store it in a free slot and wait for its completion.
+    auto slot = static_cast<std::uint32_t>(probes_.size());
+    if (free_slots_.empty())
+    {
+        probes_.emplace_back();
+    }
+    else
+    {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    }
+
+    auto& probe    = probes_[slot];
+    probe.fd       = std::move(fd);
+    probe.id       = request.id;
+    probe.start    = start;
+    probe.deadline = request.deadline;
+
+    auto ev = epoll_event();
+    ev.events   = EPOLLOUT;
+    ev.data.u64 = slot;
+    ::epoll_ctl(epoll_.get(), EPOLL_CTL_ADD, probe.fd.get(), &ev);
+
+    deadlines_.insert(Deadline(probe.deadline, slot));
+    return true;
+}
+
+void TcpProbeEngine::finish_probe(std::uint32_t slot, bool available)
+{
+    auto& probe = probes_[slot];
+    auto rtt    = duration_cast<microseconds>(Clock::now() - probe.start);
+    auto id     = probe.id;
+
+    // Closing the socket removes it from epoll.
+    probe.fd.reset();
+    deadlines_.erase(Deadline(probe.deadline, slot));
+    free_slots_.push_back(slot);
+
+    completion_(id, ProbeResult{available, rtt});
+}
+
+int TcpProbeEngine::next_timeout() const
+{
+    if (deadlines_.empty())
+    {
+        return -1;
+    }
+
+    // Round up, waking up early would only spin.
+    auto left = duration_cast<milliseconds>(deadlines_.begin()->first - Clock::now());
+    if (left.count() < 0)
+    {
+        return 0;
+    }
+    return static_cast<int>(left.count()) + 1;
+}
+
+unsigned TcpProbeEngine::expire_probes()
+{
+    auto now     = Clock::now();
+    auto expired = 0u;
+
+    while (!deadlines_.empty() && (deadlines_.begin()->first <= now))
+    {
+        finish_probe(deadlines_.begin()->second, false);
+        ++expired;
+    }
+    return expired;
+}
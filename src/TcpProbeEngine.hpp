@@ -0,0 +1,96 @@
+/**
+ * @file      TcpProbeEngine.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Probe engine based on non-blocking tcp connects.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef TCPPROBEENGINE_HPP_201812281104
+#define TCPPROBEENGINE_HPP_201812281104
+
+#include <set>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include "FileDescriptor.hpp"
+#include "ProbeEngine.hpp"
+
+// Probes tcp endpoints with non-blocking connects. A single thread waits
+// for the completion of all connects in flight with epoll. Each probe has
+// its own deadline, probes exceeding it are reported as unavailable.
+class TcpProbeEngine : public ProbeEngine
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Constructor: @p completion is called for each finished probe.
+    explicit TcpProbeEngine(Completion completion);
+
+    // Destructor: Stops the engine thread. Probes in flight are dropped.
+    virtual ~TcpProbeEngine();
+
+    // ProbeEngine interface implementation. See ProbeEngine.hpp
+    virtual void submit(std::vector<ProbeRequest> const& requests) override;
+
+    // Disable Copy and Move Semantics
+    TcpProbeEngine(TcpProbeEngine const& other) = delete;
+    TcpProbeEngine(TcpProbeEngine&& other) = delete;
+    TcpProbeEngine& operator = (TcpProbeEngine const& other) = delete;
+    TcpProbeEngine& operator = (TcpProbeEngine&& other) = delete;
+
+private:
+    // Connect in flight. Slots of finished connects are reused.
+    struct Probe
+    {
+        FileDescriptor    fd;
+        std::size_t       id = 0;
+        Clock::time_point start;
+        Clock::time_point deadline;
+    };
+
+    // Deadlines of all connects in flight, ordered by time.
+    using Deadline  = std::pair<Clock::time_point, std::uint32_t>;
+    using Deadlines = std::set<Deadline>;
+
+    // Engine thread: Starts submitted connects and waits for their completion.
+    void run();
+
+    // Start connect for @p request. Returns false if no socket is available.
+    bool start_probe(ProbeRequest const& request);
+
+    // Finish connect in @p slot and report the result.
+    void finish_probe(std::uint32_t slot, bool available);
+
+    // Get time in milliseconds until the next deadline, -1 if there is none.
+    int next_timeout() const;
+
+    // Finish all connects that exceeded their deadline. Returns their number.
+    unsigned expire_probes();
+
+    Completion                 completion_;
+    FileDescriptor             epoll_;
+    FileDescriptor             event_;
+    std::atomic_bool           running_;
+    std::thread                thread_;
+
+    // Submitted requests, filled by submit(), drained by the engine thread.
+    std::mutex                 mtx_;
+    std::vector<ProbeRequest>  submitted_;
+
+    // Owned by the engine thread.
+    std::vector<Probe>         probes_;
+    std::vector<std::uint32_t> free_slots_;
+    Deadlines                  deadlines_;
+    std::deque<ProbeRequest>   backlog_;
+};
+
+#endif // TCPPROBEENGINE_HPP_201812281104
@@ -0,0 +1,112 @@
+/**
+ * @file      TimerWheel.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Hierarchical timer wheel.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "TimerWheel.hpp"
+
+namespace
+{
+// Get slot index of @p tick in wheel level @p level.
+std::size_t slot_index(TimerWheel::Tick tick, unsigned level)
+{
+    auto shift = TimerWheel::level_bits * level;
+    return static_cast<std::size_t>((tick >> shift) & (TimerWheel::level_slots - 1));
+}
+} // namespace anon
+
+TimerWheel::TimerWheel(Tick now)
+    : levels_()
+    , now_(now)
+    , size_(0)
+    , expired_()
+{
+}
+
+void TimerWheel::schedule(Id id, Tick expiry)
+{
+    // Timers in the past expire on the next tick, timers too far in the
+    // future are clamped to the range of the wheel.
+    if (expiry <= now_)
+    {
+        expiry = now_ + 1;
+    }
+    else if (expiry - now_ > max_ticks)
+    {
+        expiry = now_ + max_ticks;
+    }
+
+    insert(Timer{id, expiry});
+    ++size_;
+}
+
+void TimerWheel::advance(Tick now, Handler const& handler)
+{
+    while (now_ < now)
+    {
+        ++now_;
+
+        // Lower level wrapped around: refill it from the next higher level.
+        for (auto level = 1u; level < level_count; ++level)
+        {
+            if (slot_index(now_, level - 1) != 0)
+            {
+                break;
+            }
+            cascade(level);
+        }
+
+        // Expire all timers in the current slot. The slot is swapped into a
+        // scratch buffer first, the handler may schedule new timers.
+        expired_.clear();
+        expired_.swap(levels_[0][slot_index(now_, 0)]);
+        size_ -= expired_.size();
+
+        for (auto const& timer : expired_)
+        {
+            handler(timer.id);
+        }
+    }
+}
+
+TimerWheel::Tick TimerWheel::get_tick() const
+{
+    return now_;
+}
+
+std::size_t TimerWheel::size() const
+{
+    return size_;
+}
+
+void TimerWheel::insert(Timer const& timer)
+{
+    // Search the lowest level whose range covers the timers expiry.
+    auto delta = timer.expiry - now_;
+    auto level = 0u;
+
+    while ((level + 1 < level_count) && (delta >= (Tick(1) << (level_bits * (level + 1)))))
+    {
+        ++level;
+    }
+    levels_[level][slot_index(timer.expiry, level)].push_back(timer);
+}
+
+void TimerWheel::cascade(unsigned level)
+{
+    auto timers = Slot();
+    timers.swap(levels_[level][slot_index(now_, level)]);
+
+    for (auto const& timer : timers)
+    {
+        insert(timer);
+    }
+}
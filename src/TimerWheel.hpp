@@ -0,0 +1,78 @@
+/**
+ * @file      TimerWheel.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Hierarchical timer wheel.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef TIMERWHEEL_HPP_201812271942
+#define TIMERWHEEL_HPP_201812271942
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+// Hierarchical timer wheel. Timers are identified by an id and expire
+// at a given tick. Scheduling and expiring a timer costs O(1) regardless
+// of the number of timers. The wheel is not thread safe.
+class TimerWheel
+{
+public:
+    using Id      = std::size_t;
+    using Tick    = std::uint64_t;
+    using Handler = std::function<void(Id)>;
+
+    // Number of wheel levels and slots per level. Timers with an expiry
+    // beyond the range of all levels are clamped to the last tick in range.
+    static unsigned const level_bits  = 6;
+    static unsigned const level_count = 4;
+    static unsigned const level_slots = 1u << level_bits;
+    static Tick const     max_ticks   = (Tick(1) << (level_bits * level_count)) - 1;
+
+    // Constructor: The wheel starts at tick @p now.
+    explicit TimerWheel(Tick now = 0);
+
+    // Schedule timer @p id to expire at tick @p expiry. Expiries in the past
+    // are expired on the next call of advance().
+    void schedule(Id id, Tick expiry);
+
+    // Advance wheel to tick @p now. @p handler is called for each expired timer.
+    void advance(Tick now, Handler const& handler);
+
+    // Get current tick of the wheel.
+    Tick get_tick() const;
+
+    // Get number of scheduled timers.
+    std::size_t size() const;
+
+private:
+    struct Timer
+    {
+        Id   id;
+        Tick expiry;
+    };
+
+    using Slot  = std::vector<Timer>;
+    using Level = std::array<Slot, level_slots>;
+
+    // Place timer into the slot matching its expiry.
+    void insert(Timer const& timer);
+
+    // Move all timers of the current slot in @p level to the lower levels.
+    void cascade(unsigned level);
+
+    std::array<Level, level_count> levels_;
+    Tick                           now_;
+    std::size_t                    size_;
+    Slot                           expired_;
+};
+
+#endif // TIMERWHEEL_HPP_201812271942
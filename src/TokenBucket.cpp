@@ -0,0 +1,49 @@
+/**
+ * @file      TokenBucket.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Token bucket rate limiter.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <algorithm>
+#include "TokenBucket.hpp"
+
+TokenBucket::TokenBucket(unsigned rate, Clock::time_point now)
+    : rate_(static_cast<double>(rate))
+    , capacity_(std::max(static_cast<double>(rate), 1.0))
+    , tokens_(capacity_)
+    , last_(now)
+{
+}
+
+bool TokenBucket::is_available(Clock::time_point now)
+{
+    // Refill tokens for the time passed since the last call
+    auto elapsed = std::chrono::duration<double>(now - last_).count();
+    if (elapsed > 0.0)
+    {
+        tokens_ = std::min(tokens_ + elapsed * rate_, capacity_);
+        last_   = now;
+    }
+    return tokens_ >= 1.0;
+}
+
+void TokenBucket::take()
+{
+    tokens_ = std::max(tokens_ - 1.0, 0.0);
+}
+
+TokenBucket::Clock::duration TokenBucket::reserve()
+{
+    // Reserved tokens are owed, the refill pays them back first.
+    tokens_ -= 1.0;
+
+    auto wait = std::chrono::duration<double>(std::max(-tokens_, 0.0) / rate_);
+    return std::chrono::duration_cast<Clock::duration>(wait);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file      TokenBucket.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Token bucket rate limiter.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef TOKENBUCKET_HPP_201812301812
+#define TOKENBUCKET_HPP_201812301812
+
+#include <chrono>
+
+// Limits events to a rate. The bucket refills with rate tokens per second and
+// holds at most one second worth of tokens. Each event takes one token, events
+// may reserve tokens in advance. Not thread safe.
+class TokenBucket
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Constructor: Allow @p rate events per second. The bucket starts full.
+    TokenBucket(unsigned rate, Clock::time_point now);
+
+    // Refill bucket up to @p now. Returns true if a token is available.
+    bool is_available(Clock::time_point now);
+
+    // Take a token. Check is_available() first.
+    void take();
+
+    // Reserve a token, even if none is available. Returns the time until
+    // the bucket refilled it, after all earlier reservations.
+    Clock::duration reserve();
+
+private:
+    double            rate_;
+    double            capacity_;
+    double            tokens_;
+    Clock::time_point last_;
+};
+
+#endif // TOKENBUCKET_HPP_201812301812
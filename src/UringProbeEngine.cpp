@@ -0,0 +1,600 @@
+/**
+ * @file      UringProbeEngine.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Probe engine based on io_uring.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "Constants.hpp"
+#include "Util.hpp"
+#include "UringProbeEngine.hpp"
+
+using namespace std::chrono;
+
+namespace
+{
+// Kind of operation a completion belongs to. Stored in the upper
+// bits of the user data, the lower bits hold the index of the operation.
+enum class Op : std::uint64_t
+{
+    Event,
+    Receive,
+    Connect,
+    LinkTimeout,
+    Send,
+    Timer
+};
+
+std::uint64_t const op_shift = 56;
+std::uint64_t const op_mask  = (std::uint64_t(1) << op_shift) - 1;
+
+std::uint64_t to_user_data(Op op, std::uint64_t index)
+{
+    return (static_cast<std::uint64_t>(op) << op_shift) | (index & op_mask);
+}
+
+Op get_op(std::uint64_t user_data)
+{
+    return static_cast<Op>(user_data >> op_shift);
+}
+
+std::uint32_t get_index(std::uint64_t user_data)
+{
+    return static_cast<std::uint32_t>(user_data & op_mask);
+}
+
+// Convert @p duration to a kernel timespec.
+template<typename Duration>
+__kernel_timespec to_timespec(Duration duration)
+{
+    auto ns = duration_cast<nanoseconds>(duration).count();
+    if (ns < 0)
+    {
+        ns = 0;
+    }
+
+    auto ts = __kernel_timespec();
+    ts.tv_sec  = ns / 1000000000;
+    ts.tv_nsec = ns % 1000000000;
+    return ts;
+}
+
+// Operations on blocking descriptors wait inside the kernel. On
+// non-blocking descriptors io_uring would fail them with EAGAIN.
+void set_blocking(int fd)
+{
+    auto flags = ::fcntl(fd, F_GETFL);
+    if (flags >= 0)
+    {
+        ::fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+    }
+}
+
+// Number of echo sequence numbers.
+std::size_t const max_echo_seq = 1u << 16;
+} // namespace anon
+
+bool UringProbeEngine::is_supported()
+{
+    auto ring = IoUring(8);
+    return ring.supports({ IORING_OP_CONNECT
+                         , IORING_OP_LINK_TIMEOUT
+                         , IORING_OP_SENDMSG
+                         , IORING_OP_RECVMSG
+                         , IORING_OP_TIMEOUT
+                         , IORING_OP_READ
+                         });
+}
+
+UringProbeEngine::UringProbeEngine(Completion completion)
+    : completion_(std::move(completion))
+    , ring_(probe_uring_entries)
+    , event_(::eventfd(0, EFD_CLOEXEC))
+    , event_value_(0)
+    , families_()
+    , running_(true)
+    , thread_()
+    , mtx_()
+    , submitted_()
+    , probes_()
+    , free_slots_()
+    , deadlines_()
+    , tcp_backlog_()
+    , icmp_backlog_()
+    , tcp_in_flight_(0)
+    , timer_()
+    , timer_deadline_()
+    , timer_generation_(0)
+    , timer_armed_(false)
+{
+    if (!ring_.is_valid() || !event_.is_valid())
+    {
+        abort("Failed to setup io_uring probe engine");
+    }
+
+    // Each connect in flight needs its own socket.
+    raise_file_limit();
+
+    // Open shared icmp sockets. Probes of a family without socket fail.
+    auto const af = std::array<int, 2>{AF_INET, AF_INET6};
+    for (auto i = std::size_t(0); i < families_.size(); ++i)
+    {
+        auto& family = families_[i];
+
+        family.sock = open_icmp_socket(af[i]);
+        if (!family.sock)
+        {
+            continue;
+        }
+
+        auto fd      = family.sock->fd.get();
+        auto buf_len = static_cast<int>(probe_icmp_buffer_size);
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buf_len, sizeof(buf_len));
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &buf_len, sizeof(buf_len));
+        set_blocking(fd);
+
+        family.echo_id = get_icmp_echo_id( family.sock.value()
+                                         , static_cast<std::uint16_t>(::getpid())
+                                         );
+        family.receives.resize(probe_uring_receives);
+    }
+
+    thread_ = std::thread([this] { run(); });
+}
+
+UringProbeEngine::~UringProbeEngine()
+{
+    // Operations in flight are canceled by the kernel once the engine thread exits.
+    running_ = false;
+    signal_event(event_.get());
+    thread_.join();
+}
+
+void UringProbeEngine::submit(std::vector<ProbeRequest> const& requests)
+{
+    {
+        auto lock = std::lock_guard<std::mutex>(mtx_);
+        submitted_.insert(submitted_.end(), requests.begin(), requests.end());
+    }
+
+    // Wakeup engine thread
+    signal_event(event_.get());
+}
+
+void UringProbeEngine::run()
+{
+    queue_event_read();
+    for (auto i = std::size_t(0); i < families_.size(); ++i)
+    {
+        for (auto j = std::size_t(0); j < families_[i].receives.size(); ++j)
+        {
+            queue_receive(i, j);
+        }
+    }
+
+    auto handler = [this] (IoUring::Cqe const& cqe) { handle_completion(cqe); };
+
+    auto startable = [] (Backlog const& backlog)
+    {
+        return !backlog.requests.empty() && !backlog.blocked;
+    };
+
+    while (running_)
+    {
+        // Submit everything queued in one system call. Don't sleep
+        // while there are probes waiting to be started.
+        auto busy = startable(tcp_backlog_) || startable(icmp_backlog_);
+        ring_.submit(busy ? 0 : 1);
+        ring_.for_each_cqe(handler);
+
+        // Completions are handled first, a reply arriving right
+        // before its deadline must not be reported as unavailable.
+        expire_probes();
+
+        start_probes(tcp_backlog_);
+        start_probes(icmp_backlog_);
+        arm_timer();
+    }
+}
+
+void UringProbeEngine::start_probes(Backlog& backlog)
+{
+    // Start probes in portions, completions are handled in between. Replies
+    // to a large portion of echo requests would overflow the socket buffer.
+    for (auto started = 0u; !backlog.requests.empty() && (started < probe_uring_start_batch); ++started)
+    {
+        auto const& request = backlog.requests.front();
+
+        auto ok = true;
+        if (request.deadline <= Clock::now())
+        {
+            completion_(request.id, ProbeResult{false, microseconds(0)});
+        }
+        else if (request.protocol == Protocol::Tcp)
+        {
+            ok = start_tcp_probe(request);
+        }
+        else
+        {
+            ok = start_icmp_probe(request);
+        }
+
+        if (!ok)
+        {
+            backlog.blocked = true;
+            return;
+        }
+        backlog.requests.pop_front();
+    }
+}
+
+void UringProbeEngine::handle_completion(IoUring::Cqe const& cqe)
+{
+    auto index = get_index(cqe.user_data);
+
+    switch (get_op(cqe.user_data))
+    {
+        case Op::Event:
+            take_submitted();
+            queue_event_read();
+            break;
+
+        case Op::Receive:
+        {
+            auto family = index / probe_uring_receives;
+            auto slot   = index % probe_uring_receives;
+            families_[family].receiving -= 1;
+            if (cqe.res > 0)
+            {
+                handle_reply(family, slot, static_cast<std::size_t>(cqe.res));
+            }
+            if ((cqe.res >= 0) || handle_receive_error(family, -cqe.res))
+            {
+                queue_receive(family, slot);
+            }
+            break;
+        }
+
+        case Op::Connect:
+            // A connect canceled by its linked timeout fails with ECANCELED.
+            finish_probe(index, cqe.res == 0);
+            break;
+
+        case Op::Send:
+        {
+            auto& probe = probes_[index];
+            probe.send_pending = false;
+
+            if (!probe.active)
+            {
+                release_slot(index);
+            }
+            else if (cqe.res < 0)
+            {
+                finish_probe(index, false);
+            }
+            break;
+        }
+
+        case Op::Timer:
+            if (index == timer_generation_)
+            {
+                timer_armed_ = false;
+            }
+            break;
+
+        case Op::LinkTimeout:
+            break;
+    }
+}
+
+void UringProbeEngine::take_submitted()
+{
+    auto lock = std::lock_guard<std::mutex>(mtx_);
+    for (auto const& request : submitted_)
+    {
+        auto& backlog = (request.protocol == Protocol::Tcp) ? tcp_backlog_ : icmp_backlog_;
+        backlog.requests.push_back(request);
+    }
+    submitted_.clear();
+}
+
+void UringProbeEngine::queue_event_read()
+{
+    auto sqe = ring_.get_sqe();
+    sqe->opcode    = IORING_OP_READ;
+    sqe->fd        = event_.get();
+    sqe->addr      = reinterpret_cast<std::uint64_t>(&event_value_);
+    sqe->len       = sizeof(event_value_);
+    sqe->user_data = to_user_data(Op::Event, 0);
+}
+
+void UringProbeEngine::queue_receive(std::size_t family, std::size_t index)
+{
+    auto& receive = families_[family].receives[index];
+
+    receive.iov.iov_base = receive.packet;
+    receive.iov.iov_len  = sizeof(receive.packet);
+
+    std::memset(&receive.msg, 0, sizeof(receive.msg));
+    receive.msg.msg_name    = &receive.from;
+    receive.msg.msg_namelen = sizeof(receive.from);
+    receive.msg.msg_iov     = &receive.iov;
+    receive.msg.msg_iovlen  = 1;
+
+    auto sqe = ring_.get_sqe();
+    sqe->opcode    = IORING_OP_RECVMSG;
+    sqe->fd        = families_[family].sock->fd.get();
+    sqe->addr      = reinterpret_cast<std::uint64_t>(&receive.msg);
+    sqe->len       = 1;
+    sqe->user_data = to_user_data(Op::Receive, family * probe_uring_receives + index);
+    families_[family].receiving += 1;
+}
+
+UringProbeEngine::Family* UringProbeEngine::get_family(Address const& addr)
+{
+    switch (addr.family())
+    {
+        case AF_INET:  return &families_[0];
+        case AF_INET6: return &families_[1];
+        default:       return nullptr;
+    }
+}
+
+std::uint32_t UringProbeEngine::allocate_slot()
+{
+    if (free_slots_.empty())
+    {
+        probes_.emplace_back();
+        return static_cast<std::uint32_t>(probes_.size() - 1);
+    }
+
+    auto slot = free_slots_.back();
+    free_slots_.pop_back();
+    return slot;
+}
+
+bool UringProbeEngine::start_tcp_probe(ProbeRequest const& request)
+{
+    auto fd = FileDescriptor(::socket(request.addr.family(), SOCK_STREAM | SOCK_CLOEXEC, 0));
+    if (!fd.is_valid())
+    {
+        // Out of descriptors: Retry as soon as a connect in flight finishes.
+        if (((errno == EMFILE) || (errno == ENFILE)) && (tcp_in_flight_ > 0))
+        {
+            return false;
+        }
+        completion_(request.id, ProbeResult{false, microseconds(0)});
+        return true;
+    }
+
+    auto slot   = allocate_slot();
+    auto& probe = probes_[slot];
+
+    probe.id       = request.id;
+    probe.addr     = request.addr;
+    probe.start    = Clock::now();
+    probe.deadline = request.deadline;
+    probe.fd       = std::move(fd);
+    probe.timeout  = to_timespec(probe.deadline - probe.start);
+    probe.active   = true;
+    ++tcp_in_flight_;
+
+    // The timeout is linked to the connect, both must be part of the same submission.
+    ring_.reserve(2);
+
+    auto sqe = ring_.get_sqe();
+    sqe->opcode    = IORING_OP_CONNECT;
+    sqe->flags     = IOSQE_IO_LINK;
+    sqe->fd        = probe.fd.get();
+    sqe->addr      = reinterpret_cast<std::uint64_t>(probe.addr.get());
+    sqe->off       = probe.addr.length;
+    sqe->user_data = to_user_data(Op::Connect, slot);
+
+    sqe = ring_.get_sqe();
+    sqe->opcode    = IORING_OP_LINK_TIMEOUT;
+    sqe->fd        = -1;
+    sqe->addr      = reinterpret_cast<std::uint64_t>(&probe.timeout);
+    sqe->len       = 1;
+    sqe->user_data = to_user_data(Op::LinkTimeout, slot);
+    return true;
+}
+
+bool UringProbeEngine::start_icmp_probe(ProbeRequest const& request)
+{
+    auto fam = get_family(request.addr);
+    if (!fam || !fam->sock)
+    {
+        completion_(request.id, ProbeResult{false, microseconds(0)});
+        return true;
+    }
+
+    // All sequence numbers in use: Wait for probes to finish.
+    auto& family = *fam;
+    if (family.in_flight.size() >= max_echo_seq)
+    {
+        return false;
+    }
+
+    auto seq = family.echo_seq++;
+    while (family.in_flight.contains(seq))
+    {
+        seq = family.echo_seq++;
+    }
+
+    auto slot   = allocate_slot();
+    auto& probe = probes_[slot];
+
+    probe.id           = request.id;
+    probe.addr         = request.addr;
+    probe.start        = Clock::now();
+    probe.deadline     = request.deadline;
+    probe.echo_seq     = seq;
+    probe.active       = true;
+    probe.send_pending = true;
+
+    // The kernel reads message and packet from the slot while sending.
+    auto echo = IcmpEcho{family.echo_id, seq};
+    probe.iov.iov_base = probe.packet;
+    probe.iov.iov_len  = make_echo_request(family.sock->family, echo, probe.packet);
+
+    std::memset(&probe.msg, 0, sizeof(probe.msg));
+    probe.msg.msg_name    = probe.addr.get();
+    probe.msg.msg_namelen = probe.addr.length;
+    probe.msg.msg_iov     = &probe.iov;
+    probe.msg.msg_iovlen  = 1;
+
+    family.in_flight.insert(seq, slot);
+    deadlines_.insert(Deadline(probe.deadline, slot));
+
+    auto sqe = ring_.get_sqe();
+    sqe->opcode    = IORING_OP_SENDMSG;
+    sqe->fd        = family.sock->fd.get();
+    sqe->addr      = reinterpret_cast<std::uint64_t>(&probe.msg);
+    sqe->len       = 1;
+    sqe->user_data = to_user_data(Op::Send, slot);
+    return true;
+}
+
+bool UringProbeEngine::handle_receive_error(std::size_t family, int error)
+{
+    // Transient errors: Receive again.
+    if ((error == EINTR) || (error == EAGAIN) || (error == ENOBUFS))
+    {
+        return true;
+    }
+
+    // Any other error fails again right away. Queuing it again would spin.
+    // Without any receive left no reply can arrive: Fail the probes in
+    // flight and close the socket, later probes of the family fail at once.
+    auto& fam = families_[family];
+    if (fam.receiving > 0)
+    {
+        return false;
+    }
+
+    // All echo requests in flight have a deadline.
+    auto slots = std::vector<std::uint32_t>();
+    for (auto const& [deadline, slot] : deadlines_)
+    {
+        if (get_family(probes_[slot].addr) == &fam)
+        {
+            slots.push_back(slot);
+        }
+    }
+    for (auto slot : slots)
+    {
+        finish_probe(slot, false);
+    }
+    fam.sock.reset();
+    return false;
+}
+
+void UringProbeEngine::handle_reply(std::size_t family, std::size_t index, std::size_t len)
+{
+    auto& fam     = families_[family];
+    auto& receive = fam.receives[index];
+
+    // Raw sockets see any echo reply on this host, check identifier and origin as well.
+    auto echo = parse_echo_reply(fam.sock.value(), receive.packet, len);
+    if (!echo || (echo->id != fam.echo_id))
+    {
+        return;
+    }
+
+    auto slot = fam.in_flight.find(echo->seq);
+    if (!slot || !same_address(receive.from, probes_[slot.value()].addr))
+    {
+        return;
+    }
+    finish_probe(slot.value(), true);
+}
+
+void UringProbeEngine::finish_probe(std::uint32_t slot, bool available)
+{
+    auto& probe = probes_[slot];
+    if (!probe.active)
+    {
+        return;
+    }
+
+    auto rtt = duration_cast<microseconds>(Clock::now() - probe.start);
+    auto id  = probe.id;
+
+    // Resources are available again, blocked probes can be started.
+    if (probe.fd.is_valid())
+    {
+        probe.fd.reset();
+        --tcp_in_flight_;
+        tcp_backlog_.blocked = false;
+    }
+    else
+    {
+        get_family(probe.addr)->in_flight.erase(probe.echo_seq);
+        deadlines_.erase(Deadline(probe.deadline, slot));
+        icmp_backlog_.blocked = false;
+    }
+
+    probe.active = false;
+    if (!probe.send_pending)
+    {
+        release_slot(slot);
+    }
+
+    completion_(id, ProbeResult{available, rtt});
+}
+
+void UringProbeEngine::release_slot(std::uint32_t slot)
+{
+    free_slots_.push_back(slot);
+}
+
+void UringProbeEngine::expire_probes()
+{
+    auto now = Clock::now();
+
+    while (!deadlines_.empty() && (deadlines_.begin()->first <= now))
+    {
+        finish_probe(deadlines_.begin()->second, false);
+    }
+}
+
+void UringProbeEngine::arm_timer()
+{
+    if (deadlines_.empty())
+    {
+        return;
+    }
+
+    // An armed timer expiring earlier wakes up the engine in time.
+    auto deadline = deadlines_.begin()->first;
+    if (timer_armed_ && (timer_deadline_ <= deadline))
+    {
+        return;
+    }
+
+    timer_           = to_timespec(deadline.time_since_epoch());
+    timer_deadline_  = deadline;
+    timer_armed_     = true;
+    timer_generation_ += 1;
+
+    // Steady clock and io_uring timeouts are both based on CLOCK_MONOTONIC.
+    auto sqe = ring_.get_sqe();
+    sqe->opcode        = IORING_OP_TIMEOUT;
+    sqe->fd            = -1;
+    sqe->addr          = reinterpret_cast<std::uint64_t>(&timer_);
+    sqe->len           = 1;
+    sqe->timeout_flags = IORING_TIMEOUT_ABS;
+    sqe->user_data     = to_user_data(Op::Timer, timer_generation_);
+}
@@ -0,0 +1,191 @@
+/**
+ * @file      UringProbeEngine.hpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Probe engine based on io_uring.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef URINGPROBEENGINE_HPP_201812291020
+#define URINGPROBEENGINE_HPP_201812291020
+
+#include <set>
+#include <deque>
+#include <array>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <sys/socket.h>
+#include <linux/time_types.h>
+#include "Icmp.hpp"
+#include "IoUring.hpp"
+#include "FlatHashMap.hpp"
+#include "FileDescriptor.hpp"
+#include "ProbeEngine.hpp"
+
+// Probes tcp and icmp hosts through a single io_uring instance. Connects are
+// submitted together with a linked timeout, echo requests are sent with
+// sendmsg on one shared socket per address family while a fixed number of
+// receives per socket is kept in flight. Many probes are submitted with a
+// single system call.
+class UringProbeEngine : public ProbeEngine
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Check if the running kernel supports everything this engine needs.
+    static bool is_supported();
+
+    // Constructor: @p completion is called for each finished probe.
+    explicit UringProbeEngine(Completion completion);
+
+    // Destructor: Stops the engine thread. Probes in flight are dropped.
+    virtual ~UringProbeEngine();
+
+    // ProbeEngine interface implementation. See ProbeEngine.hpp
+    virtual void submit(std::vector<ProbeRequest> const& requests) override;
+
+    // Disable Copy and Move Semantics
+    UringProbeEngine(UringProbeEngine const& other) = delete;
+    UringProbeEngine(UringProbeEngine&& other) = delete;
+    UringProbeEngine& operator = (UringProbeEngine const& other) = delete;
+    UringProbeEngine& operator = (UringProbeEngine&& other) = delete;
+
+private:
+    // Buffer of a receive in flight.
+    struct Receive
+    {
+        msghdr           msg;
+        iovec            iov;
+        sockaddr_storage from;
+        std::uint8_t     packet[512];
+    };
+
+    // Shared icmp socket of an address family. The socket is closed once
+    // none of its receives can be queued again.
+    struct Family
+    {
+        std::optional<IcmpSocket>                 sock;
+        std::uint16_t                             echo_id   = 0;
+        std::uint16_t                             echo_seq  = 0;
+        FlatHashMap<std::uint16_t, std::uint32_t> in_flight;
+        std::vector<Receive>                      receives;
+        std::size_t                               receiving = 0;
+    };
+
+    // Probe in flight. The kernel references the buffers of a probe until its
+    // operations complete, slots are only reused afterwards.
+    struct Probe
+    {
+        std::size_t        id = 0;
+        Address            addr;
+        Clock::time_point  start;
+        Clock::time_point  deadline;
+        FileDescriptor     fd;
+        __kernel_timespec  timeout;
+        msghdr             msg;
+        iovec              iov;
+        std::uint8_t       packet[icmp_echo_size];
+        std::uint16_t      echo_seq     = 0;
+        bool               active       = false;
+        bool               send_pending = false;
+    };
+
+    // Requests waiting to be started. Connects waiting for a free
+    // descriptor don't hold back echo requests and vice versa.
+    struct Backlog
+    {
+        std::deque<ProbeRequest> requests;
+        bool                     blocked = false;
+    };
+
+    // Deadlines of all echo requests in flight, ordered by time.
+    using Deadline  = std::pair<Clock::time_point, std::uint32_t>;
+    using Deadlines = std::set<Deadline>;
+
+    // Engine thread: Submits probes and handles their completions.
+    void run();
+
+    // Handle completion @p cqe.
+    void handle_completion(IoUring::Cqe const& cqe);
+
+    // Move newly submitted requests to their backlog.
+    void take_submitted();
+
+    // Start a portion of the requests in @p backlog.
+    void start_probes(Backlog& backlog);
+
+    // Queue read of the submission eventfd.
+    void queue_event_read();
+
+    // Queue receive @p index of family @p family.
+    void queue_receive(std::size_t family, std::size_t index);
+
+    // Get family of @p addr. Returns nullptr for unsupported families.
+    Family* get_family(Address const& addr);
+
+    // Get free probe slot.
+    std::uint32_t allocate_slot();
+
+    // Queue connect with a linked timeout. Returns false if out of descriptors.
+    bool start_tcp_probe(ProbeRequest const& request);
+
+    // Queue echo request. Returns false if no sequence number is available.
+    bool start_icmp_probe(ProbeRequest const& request);
+
+    // Handle failed receive of family @p family with error @p error.
+    // Returns true if the receive is queued again.
+    bool handle_receive_error(std::size_t family, int error);
+
+    // Handle echo reply in receive @p index of family @p family.
+    void handle_reply(std::size_t family, std::size_t index, std::size_t len);
+
+    // Finish probe in @p slot and report the result.
+    void finish_probe(std::uint32_t slot, bool available);
+
+    // Return @p slot for reuse once the kernel is done with it.
+    void release_slot(std::uint32_t slot);
+
+    // Finish all echo requests that exceeded their deadline and
+    // arm a timer for the next deadline.
+    void expire_probes();
+
+    // Arm timer expiring at the earliest echo request deadline.
+    void arm_timer();
+
+    Completion                 completion_;
+    IoUring                    ring_;
+    FileDescriptor             event_;
+    std::uint64_t              event_value_;
+    std::array<Family, 2>      families_;
+    std::atomic_bool           running_;
+    std::thread                thread_;
+
+    // Submitted requests, filled by submit(), drained by the engine thread.
+    std::mutex                 mtx_;
+    std::vector<ProbeRequest>  submitted_;
+
+    // Owned by the engine thread. A deque keeps the probes at fixed addresses.
+    std::deque<Probe>          probes_;
+    std::vector<std::uint32_t> free_slots_;
+    Deadlines                  deadlines_;
+    Backlog                    tcp_backlog_;
+    Backlog                    icmp_backlog_;
+    std::size_t                tcp_in_flight_;
+
+    // Timer of the earliest deadline. Older timers still in flight are ignored.
+    __kernel_timespec          timer_;
+    Clock::time_point          timer_deadline_;
+    std::uint32_t              timer_generation_;
+    bool                       timer_armed_;
+};
+
+#endif // URINGPROBEENGINE_HPP_201812291020
@@ -11,8 +11,14 @@
  * directory for more details.
  */
 
+#include <array>
 #include <cstdint>
 #include <cstring>
+#include <charconv>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <iterator>
+#include <algorithm>
 #include "Constants.hpp"
 #include "Util.hpp"
 #include "UserInterface.hpp"
@@ -52,6 +58,38 @@ std::string make_header_string(std::vector<ConfigGlobal::FieldFmt> const& fmt)
                 append_and_fill(tmp, ui_header_interval, len);
                 break;
 
+            case Field::RttLast:
+                append_and_fill(tmp, ui_header_rtt_last, len);
+                break;
+
+            case Field::RttMin:
+                append_and_fill(tmp, ui_header_rtt_min, len);
+                break;
+
+            case Field::RttAvg:
+                append_and_fill(tmp, ui_header_rtt_avg, len);
+                break;
+
+            case Field::RttMax:
+                append_and_fill(tmp, ui_header_rtt_max, len);
+                break;
+
+            case Field::RttJitter:
+                append_and_fill(tmp, ui_header_rtt_jitter, len);
+                break;
+
+            case Field::RttP50:
+                append_and_fill(tmp, ui_header_rtt_p50, len);
+                break;
+
+            case Field::RttP95:
+                append_and_fill(tmp, ui_header_rtt_p95, len);
+                break;
+
+            case Field::RttP99:
+                append_and_fill(tmp, ui_header_rtt_p99, len);
+                break;
+
             default:
                 append_and_fill(tmp, "", len);
         }
@@ -70,14 +108,49 @@ std::string make_header_string(std::vector<ConfigGlobal::FieldFmt> const& fmt)
 } // namespace anon
 
 UserInterface::UserInterface( std::vector<GroupElement::Pointer> const&  groups
+                            , HostTable&                                 hosts
                             , std::vector<ConfigGlobal::FieldFmt> const& fmt
+                            , Layout                                     layout
                             )
     : wnd_(nullptr)
     , groups_(groups)
+    , hosts_(hosts)
+    , layout_(layout)
+    , grid_{1, 0, false}
+    , group_lines_()
+    , content_lines_(0)
+    , row_width_(0)
+    , content_width_(0)
+    , offset_(0)
+    , shown_()
+    , summarized_()
+    , footer_pos_()
+    , frames_(0)
+    , coalesced_(0)
 {
     header_ = make_header_string(fmt);
 
+    // Assemble list width from the contents. The contents don't
+    // change, the width is only calculated once.
+    for (auto const& grp : groups_)
+    {
+        content_width_ = std::max(content_width_, grp->get_width());
+    }
+
+    // Add Room of the Header and Footer
+    row_width_     = static_cast<unsigned>(header_.size());
+    content_width_ = std::max( content_width_
+                             , static_cast<unsigned>(header_.size())
+                             );
+    content_width_ = std::max( content_width_
+                             , static_cast<unsigned>(std::strlen(ui_footer_quit))
+                             );
+
+    // Add Borders
+    content_width_ += 2 * ui_border_width;
+
     setup_curses();
+    layout_ui();
 }
 
 UserInterface::~UserInterface()
@@ -85,10 +158,9 @@ UserInterface::~UserInterface()
     teardown_curses();
 }
 
-void UserInterface::rebuild_ui(void)
+void UserInterface::resize_ui(void)
 {
-    teardown_curses();
-    setup_curses();
+    layout_ui();
 }
 
 void UserInterface::draw(void)
@@ -110,23 +182,46 @@ void UserInterface::draw(void)
     wnd_->erase();
 
     // Add Header
-    wnd_->move_to(pos);
-    wnd_->add_string(header_, chars_left);
+    draw_header(pos, static_cast<std::size_t>(chars_left));
 
     pos.x = ui_border_width;
     pos.y += ui_line_offset_y;
     wnd_->move_to(pos);
     wnd_->add_horizontal_line(line_len);
 
-    // Add Groups
-    for (auto grp : groups_)
+    // Add groups in view. Only visible lines are visited, hosts
+    // drawn in the last frame are hidden first.
+    for (auto host : shown_)
+    {
+        hosts_.hide(host);
+    }
+    shown_.clear();
+    summarized_.clear();
+
+    auto view  = get_view_lines();
+    auto first = offset_;
+    auto last  = std::min(offset_ + view, content_lines_);
+    auto base  = pos.y;
+
+    // Start with the group holding the first line in view
+    auto it  = std::upper_bound(group_lines_.begin(), group_lines_.end(), first);
+    auto grp = static_cast<std::size_t>(std::distance(group_lines_.begin(), it));
+    grp = (grp > 0) ? (grp - 1) : 0;
+
+    for (; (grp < groups_.size()) && (group_lines_[grp] < last); ++grp)
     {
-        grp->draw(wnd_, pos);
+        // Place pos on the line before the first line to draw
+        auto start = group_lines_[grp];
+        auto skip  = (first > start) ? (first - start) : 0;
+        pos.y = base + (start + skip - first);
+        groups_[grp]->draw_lines(wnd_, pos, skip, last - (start + skip), grid_, shown_);
 
-        // Add empty line between groups
-        pos.y += 1;
+        if ((skip == 0) && groups_[grp]->has_summary())
+        {
+            summarized_.push_back(groups_[grp].get());
+        }
     }
-    pos.y -= 1;
+    pos.y = base + (last - first);
 
     // Add Footer
     pos.x = ui_border_width;
@@ -136,59 +231,269 @@ void UserInterface::draw(void)
 
     pos.x += ui_line_offset_x;
     pos.y += ui_line_offset_y;
-    wnd_->move_to(pos);
-    wnd_->add_string(ui_footer_quit, chars_left);
+    footer_pos_ = pos;
+
+    frames_ += 1;
+    draw_footer();
 
     // Refresh
     wnd_->add_border();
     wnd_->refresh();
+    Window::update();
 }
 
-void UserInterface::setup_curses()
+void UserInterface::draw_header(Position const& pos, std::size_t width)
 {
-    auto height           = unsigned(0);
-    auto width            = unsigned(0);
-    auto content_origin_x = unsigned(0);
-    auto content_origin_y = unsigned(0);
-    auto content_height   = unsigned(0);
-    auto content_width    = unsigned(0);
+    // The heatmap has no fields, explain the colors instead
+    if (grid_.state_only)
+    {
+        wnd_->move_to(pos);
+        wnd_->add_string(ui_header_heatmap, width);
+        return;
+    }
+
+    // Each column gets a header
+    for (auto i = 0u; i < grid_.per_line; ++i)
+    {
+        auto x = i * grid_.cell_width;
+        if (x >= width)
+        {
+            break;
+        }
+        wnd_->move_to(Position(pos.x + x, pos.y));
+        wnd_->add_string(header_, width - x);
+    }
+}
+
+void UserInterface::draw_changes(HostTable::Changed const& changed)
+{
+    if (changed.empty())
+    {
+        return;
+    }
+
+    for (auto host : changed)
+    {
+        hosts_.draw_status(wnd_, host);
+    }
+
+    // Changed round trip times change the summaries as well
+    for (auto grp : summarized_)
+    {
+        grp->draw_summary(wnd_);
+    }
+
+    // All changes beyond the first share this frame
+    frames_    += 1;
+    coalesced_ += changed.size() - 1;
+    draw_footer();
+    wnd_->refresh();
+    Window::update();
+}
+
+void UserInterface::draw_footer()
+{
+    auto chars_left = static_cast<int>(wnd_->get_width() - (2 * (ui_border_width + ui_line_offset_x)));
+    chars_left = (chars_left < 0) ? 0 : chars_left;
+
+    // Add footer piece by piece while there is room left. Numbers
+    // are formatted in place, drawing the footer doesn't allocate.
+    auto room = static_cast<std::size_t>(chars_left);
+    auto num  = std::array<char, 24>();
+
+    auto add = [this, &room] (char const* str, std::size_t len)
+    {
+        len = std::min(len, room);
+        wnd_->add_string(str, len);
+        room -= len;
+    };
+    auto add_str = [&add] (char const* str)
+    {
+        add(str, std::strlen(str));
+    };
+    auto add_num = [&add, &num] (std::uint64_t value)
+    {
+        auto res = std::to_chars(num.data(), num.data() + num.size(), value);
+        add(num.data(), static_cast<std::size_t>(res.ptr - num.data()));
+    };
+
+    wnd_->move_to(footer_pos_);
+    add_str(ui_footer_quit);
+    add_str(ui_field_space);
+    add_str(ui_footer_layout);
+    add_str(ui_field_space);
+    add_str(ui_footer_frames);
+    add_num(frames_);
+    add_str(ui_field_space);
+    add_str(ui_footer_coalesced);
+    add_num(coalesced_);
+
+    // Show scroll position if not everything fits
+    auto view = get_view_lines();
+    if (content_lines_ > view)
+    {
+        add_str(ui_field_space);
+        add_str(ui_footer_scroll);
+        add_str(ui_field_space);
+        add_str("Lines ");
+        add_num(offset_ + 1);
+        add_str("-");
+        add_num(std::min(offset_ + view, content_lines_));
+        add_str(" of ");
+        add_num(content_lines_);
+    }
+}
+
+bool UserInterface::handle_input(bool& closed)
+{
+    auto redraw = false;
+    auto keys   = 0u;
+    auto view   = get_view_lines();
+    auto end    = content_lines_ - std::min(content_lines_, view);
+
+    for (auto key = wgetch(stdscr); key != ERR; key = wgetch(stdscr))
+    {
+        keys += 1;
+        switch (key)
+        {
+            case KEY_UP:
+                redraw |= scroll_to((offset_ > 0) ? (offset_ - 1) : 0);
+                break;
+
+            case KEY_DOWN:
+                redraw |= scroll_to(offset_ + 1);
+                break;
+
+            case KEY_PPAGE:
+                redraw |= scroll_to((offset_ > view) ? (offset_ - view) : 0);
+                break;
+
+            case KEY_NPAGE:
+                redraw |= scroll_to(offset_ + view);
+                break;
+
+            case KEY_HOME:
+                redraw |= scroll_to(0);
+                break;
+
+            case KEY_END:
+                redraw |= scroll_to(end);
+                break;
+
+            // Switch to the next layout
+            case 'l':
+                layout_ = (layout_ == Layout::List)    ? Layout::Columns
+                        : (layout_ == Layout::Columns) ? Layout::Heatmap
+                        :                                Layout::List;
+                layout_ui();
+                view   = get_view_lines();
+                end    = content_lines_ - std::min(content_lines_, view);
+                redraw = true;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    closed |= (keys == 0);
+    return redraw;
+}
+
+unsigned UserInterface::get_view_lines() const
+{
+    auto reserved = 2 * ui_border_width + ui_header_height + ui_footer_height;
+    auto height   = wnd_->get_height();
+    return (height > reserved) ? (height - reserved) : 0;
+}
 
+bool UserInterface::scroll_to(unsigned offset)
+{
+    // Don't scroll past the last line
+    auto view = get_view_lines();
+    offset = std::min(offset, content_lines_ - std::min(content_lines_, view));
+
+    if (offset == offset_)
+    {
+        return false;
+    }
+    offset_ = offset;
+    return true;
+}
+
+void UserInterface::setup_curses()
+{
     // Setup curses screen
     initscr();
     noecho();
     curs_set(0);
     start_color();
     use_default_colors();
-    clear();
-    refresh();
+    Window::init_colors();
+
+    // Read scroll keys without blocking. Windows are pads and can't
+    // read input themselves.
+    keypad(stdscr, TRUE);
+    nodelay(stdscr, TRUE);
+}
+
+void UserInterface::layout_ui()
+{
+    auto height           = unsigned(0);
+    auto width            = unsigned(0);
+    auto content_origin_x = unsigned(0);
+    auto content_origin_y = unsigned(0);
+    auto content_height   = unsigned(0);
+    auto content_width    = content_width_;
 
-    // Setup Window
+    // Resize curses in place to the current terminal size.
+    auto size = winsize();
+    if ((::ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0) && is_term_resized(size.ws_row, size.ws_col))
+    {
+        resizeterm(size.ws_row, size.ws_col);
+    }
     getmaxyx(stdscr, height, width);
 
-    // Assemble ui height and width from the contents
-    for (auto grp : groups_)
+    // Blank the screen with the next update instead of right away,
+    // the window is shown in the same update.
+    werase(stdscr);
+    wnoutrefresh(stdscr);
+
+    // The list is as wide as its contents, the other layouts
+    // fill the entire terminal width.
+    if (layout_ != Layout::List)
     {
-        content_height += grp->get_height();
-        content_width = std::max(content_width, grp->get_width());
+        content_width = width;
     }
+    content_width = std::min(content_width, width);
 
-    // Add lines for whitespaces between groups
-    content_height += static_cast<unsigned>(ui_line_offset_y * groups_.size() - 1);
+    // Arrange hosts in the room left by borders and offsets
+    auto reserved = 2 * (ui_border_width + ui_line_offset_x);
+    auto room     = (content_width > reserved) ? (content_width - reserved) : 0;
 
-    // Add Room of the Header and Footer
-    content_height += ui_header_height;
-    content_width = std::max( content_width
-                            , static_cast<unsigned>(header_.size())
-                            );
+    switch (layout_)
+    {
+        case Layout::Columns:
+        {
+            auto cell_width = row_width_ + ui_column_gap;
+            grid_ = GroupElement::Grid{ std::max((room + ui_column_gap) / cell_width, 1u)
+                                      , cell_width
+                                      , false
+                                      };
+            break;
+        }
 
-    content_height += ui_footer_height;
-    content_width = std::max( content_width
-                            , static_cast<unsigned>(std::strlen(ui_footer_quit))
-                            );
+        case Layout::Heatmap:
+            grid_ = GroupElement::Grid{std::max(room, 1u), 1, true};
+            break;
 
-    // Add Borders
-    content_width  += 2 * ui_border_width;
-    content_height += 2 * ui_border_width;
+        default:
+            grid_ = GroupElement::Grid{1, room, false};
+    }
+    index_groups();
+
+    // Add Room of the Header, Footer and Borders
+    content_height = content_lines_ + ui_header_height + ui_footer_height + 2 * ui_border_width;
 
     // Calculate window origin and prevent programm from
     // crashing if the window doesn't fit into the terminal.
@@ -212,24 +517,40 @@ void UserInterface::setup_curses()
         content_height = height;
     }
 
-    // Rebuild window with based on current terminal size
-    wnd_ = std::make_shared<Window>( Position( content_origin_x
-                                             , content_origin_y
-                                             )
-                                   , content_width
-                                   , content_height
-                                   );
+    // Create window once, afterwards it is resized
+    auto origin = Position(content_origin_x, content_origin_y);
+    if (wnd_)
+    {
+        wnd_->resize(origin, content_width, content_height);
+    }
+    else
+    {
+        wnd_ = std::make_shared<Window>(origin, content_width, content_height);
+    }
+
+    // Keep the view in range
+    scroll_to(offset_);
+}
+
+void UserInterface::index_groups()
+{
+    // Groups are separated by an empty line. Only depends
+    // on the number of groups, not on the number of hosts.
+    group_lines_.clear();
+
+    auto line = 0u;
+    for (auto const& grp : groups_)
+    {
+        group_lines_.push_back(line);
+        line += grp->get_height(grid_) + ui_line_offset_y;
+    }
+    content_lines_ = groups_.empty() ? 0 : line - ui_line_offset_y;
 }
 
 void UserInterface::teardown_curses()
 {
-    // Cleanup Window
-    wnd_->erase();
-    wnd_->refresh();
+    // Cleanup Window and Curses. The screen is overwritten
+    // by the next update or restored by endwin.
     wnd_.reset();
-
-    // Cleanup Curses
-    clear();
-    refresh();
     endwin();
 }
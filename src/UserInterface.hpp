@@ -16,6 +16,7 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
 #include "Window.hpp"
 #include "GroupElement.hpp"
 
@@ -23,20 +24,33 @@
 class UserInterface
 {
 public:
-    // Constructor. @p groups are the groups that should be in the ui.
-    // @p fmt contains the fields on display and their order.
+    // Constructor. @p groups are the groups that should be in the ui,
+    // their hosts are in @p hosts. @p fmt contains the fields on display
+    // and their order. @p layout is the initial arrangement of the hosts.
     UserInterface( std::vector<GroupElement::Pointer> const&  groups
+                 , HostTable&                                 hosts
                  , std::vector<ConfigGlobal::FieldFmt> const& fmt
+                 , Layout                                     layout
                  );
 
     ~UserInterface();
 
-    // Rebuild entire ui. Call in case the terminal dimensions change.
-    void rebuild_ui(void);
+    // Adapt ui to the current terminal size. Call in case the
+    // terminal dimensions change. Curses keeps running.
+    void resize_ui(void);
 
     // Draw current ui state.
     void draw(void);
 
+    // Redraw status of the @p changed hosts only. Hosts must have
+    // been drawn by draw() before.
+    void draw_changes(HostTable::Changed const& changed);
+
+    // Read pending key input, scroll and switch layouts accordingly.
+    // Doesn't block. Returns true if the ui must be redrawn. Input that is
+    // readable without a single key is at its end, @p closed is set then.
+    bool handle_input(bool& closed);
+
     // Disable Copy and Move Semantics
     UserInterface(UserInterface const& other) = delete;
     UserInterface(UserInterface&& other) = delete;
@@ -50,10 +64,56 @@ private:
     // Cleanup curses
     void teardown_curses();
 
+    // Size and place the window according to the terminal size
+    // and arrange the hosts according to the layout.
+    void layout_ui();
+
+    // Index the first line of each group in the current grid.
+    void index_groups();
+
+    // Draw column headers or the heatmap legend at @p pos.
+    void draw_header(Position const& pos, std::size_t width);
+
+    // Get number of content lines fitting into the window.
+    unsigned get_view_lines() const;
+
+    // Scroll to content line @p offset. Returns true if the view moved.
+    bool scroll_to(unsigned offset);
+
+    // Draw footer line with frame statistics and scroll position.
+    void draw_footer();
+
     Window::Pointer                    wnd_;
     std::vector<GroupElement::Pointer> groups_;
+    HostTable&                         hosts_;
     std::string                        header_;
     std::string                        footer_;
+
+    // Layout and the resulting arrangement of the hosts.
+    Layout                             layout_;
+    GroupElement::Grid                 grid_;
+
+    // First content line of each group. Finds the groups in view in O(log groups).
+    std::vector<unsigned>              group_lines_;
+    unsigned                           content_lines_;
+
+    // Width of a host in the list, and of the entire list including
+    // borders. Independent of the terminal.
+    unsigned                           row_width_;
+    unsigned                           content_width_;
+
+    // First content line in view and the hosts drawn in view.
+    unsigned                           offset_;
+    HostTable::Changed                 shown_;
+
+    // Groups with their summary in view, redrawn with each change.
+    std::vector<GroupElement*>         summarized_;
+
+    // Footer position and statistics shown there: Frames drawn and state
+    // changes drawn together with others in a single frame.
+    Position                           footer_pos_;
+    std::uint64_t                      frames_;
+    std::uint64_t                      coalesced_;
 };
 
 #endif // USERINTERFACE_HPP_201804081223
@@ -15,6 +15,13 @@
 #include <algorithm>
 #include <cctype>
 #include <cstdlib>
+#include <cstdint>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "Constants.hpp"
 #include "Util.hpp"
 
 std::string_view trim_view(std::string_view const& s)
@@ -24,19 +31,20 @@ std::string_view trim_view(std::string_view const& s)
     return (wsback <= wsfront) ? std::string_view() : std::string_view(wsfront, wsback - wsfront);
 }
 
-std::optional<int> string_to_int(std::string const& str)
+std::optional<int> string_to_int(std::string_view const& str)
 {
-    try
-    {
-        return std::stoi(str);
-    }
-    catch (...)
+    auto value = int(0);
+    auto last  = str.data() + str.size();
+
+    auto [end, ec] = std::from_chars(str.data(), last, value);
+    if ((ec != std::errc()) || (end != last))
     {
         return {};
     }
+    return value;
 }
 
-void append_and_fill( std::string& dst, std::string const& src, unsigned len)
+void append_and_fill( std::string& dst, std::string_view const& src, unsigned len)
 {
     auto left = static_cast<int>(len) - static_cast<int>(src.size());
 
@@ -53,28 +61,70 @@ void append_and_fill( std::string& dst, std::string const& src, unsigned len)
     }
 }
 
+void signal_event(int fd)
+{
+    auto val = std::uint64_t(1);
+    while ((::write(fd, &val, sizeof(val)) < 0) && (errno == EINTR))
+    {
+    }
+}
+
+void clear_event(int fd)
+{
+    auto val = std::uint64_t(0);
+    while ((::read(fd, &val, sizeof(val)) < 0) && (errno == EINTR))
+    {
+    }
+}
+
+void raise_file_limit()
+{
+    auto limit = rlimit();
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
 void abort(std::string error_msg)
 {
     std::cerr << "Error occured: '" << error_msg << "'. Abort" << std::endl;
     exit(-1);
 }
 
-std::string make_proto_port_string( std::string const&                protocol
-                                  , std::optional<std::string> const& port
+std::string make_proto_port_string( Protocol      protocol
+                                  , std::uint16_t port
                                   )
 {
-    auto tmp = protocol;
-    if (port)
+    auto tmp = protocol_to_string(protocol);
+    if (port != 0)
     {
-        auto const& p = port.value();
-
         tmp.insert(tmp.end(), 1, ':');
-        tmp.insert(tmp.end(), p.begin(), p.end());
+        tmp.append(std::to_string(port));
     }
     return tmp;
 }
 
-std::string make_interval_string(std::string const& interval)
+std::string make_interval_string(std::chrono::seconds interval)
 {
-    return interval + "s";
+    return std::to_string(interval.count()) + "s";
+}
+
+char* format_rtt(char* first, char* last, std::chrono::microseconds rtt)
+{
+    auto value = static_cast<std::uint64_t>(std::max(rtt.count(), std::chrono::microseconds::rep(0)));
+    auto unit  = std::strlen(ui_rtt_unit);
+
+    // Whole milliseconds, leave room for the tenth and the unit
+    auto [end, ec] = std::to_chars(first, last, value / 1000);
+    if ((ec != std::errc()) || (static_cast<std::size_t>(last - end) < (2 + unit)))
+    {
+        return first;
+    }
+
+    *end++ = '.';
+    *end++ = static_cast<char>('0' + (value % 1000) / 100);
+    std::memcpy(end, ui_rtt_unit, unit);
+    return end + unit;
 }
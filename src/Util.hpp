@@ -15,28 +15,46 @@
 #define UTIL_HPP_201804081223
 
 #include <string>
+#include <string_view>
 #include <optional>
+#include <chrono>
+#include <cstdint>
+#include "Config.hpp"
 
 // Remove leading and trailing whitespaces from given string_view
 std::string_view trim_view(std::string_view const& s);
 
-// Convert string to int. In case string can't be converted
-// an empty optional is returned.
-std::optional<int> string_to_int(std::string const& str);
+// Convert string to int. In case the entire string can't be converted
+// an empty optional is returned. Doesn't allocate or throw.
+std::optional<int> string_to_int(std::string_view const& str);
 
 // Append @p len characters from @p src to @p dst. In case len is more than src.size()
 // the remaining characters are filled with spaces.
-void append_and_fill( std::string& dst, std::string const& src, unsigned len);
+void append_and_fill( std::string& dst, std::string_view const& src, unsigned len);
+
+// Signal eventfd @p fd.
+void signal_event(int fd);
+
+// Reset eventfd @p fd after it was signaled.
+void clear_event(int fd);
+
+// Raise the soft limit of open files up to the hard limit.
+void raise_file_limit();
 
 // Abort program (critical error occured).
 void abort(std::string error_msg);
 
-// Make combined string with <protocol:port>.
-std::string make_proto_port_string( std::string const&                protocol
-                                  , std::optional<std::string> const& port
+// Make combined string with <protocol:port>. Port 0 is left out.
+std::string make_proto_port_string( Protocol      protocol
+                                  , std::uint16_t port
                                   );
 
 // Make interval string <interval>s.
-std::string make_interval_string(std::string const& interval);
+std::string make_interval_string(std::chrono::seconds interval);
+
+// Write round trip time @p rtt as <milliseconds>.<tenth>ms into [@p first, @p last).
+// Doesn't allocate. Returns the end of the written characters, @p first if
+// the buffer is too small.
+char* format_rtt(char* first, char* last, std::chrono::microseconds rtt);
 
 #endif // UTIL_HPP_201804081223
@@ -11,8 +11,44 @@
  * directory for more details.
  */
 
+#include <array>
+#include <cstring>
+#include <algorithm>
 #include "Window.hpp"
 
+namespace
+{
+// Number of colors, including the default color.
+std::size_t const color_count = 9;
+
+// Attributes of all color pairs, indexed by background and foreground
+// color. Pairs with the default background come first, they get the
+// lowest pair numbers and fit into any terminal supporting colors.
+std::array<attr_t, color_count * color_count> color_attrs = {};
+
+std::size_t get_color_index(Window::Color fg, Window::Color bg)
+{
+    auto fg_index = static_cast<std::size_t>(static_cast<short>(fg) + 1);
+    auto bg_index = static_cast<std::size_t>(static_cast<short>(bg) + 1);
+    return bg_index * color_count + fg_index;
+}
+} // namespace anon
+
+void Window::init_colors()
+{
+    for (auto bg = short(-1); bg < short(color_count - 1); ++bg)
+    {
+        for (auto fg = short(-1); fg < short(color_count - 1); ++fg)
+        {
+            auto index = get_color_index(Window::Color(fg), Window::Color(bg));
+            auto pair  = static_cast<short>(index + 1);
+
+            // Pairs the terminal doesn't support are drawn without color
+            color_attrs[index] = (init_pair(pair, fg, bg) == OK) ? COLOR_PAIR(pair) : A_NORMAL;
+        }
+    }
+}
+
 Window::Window( Position const& origin
               , unsigned        width
               , unsigned        height
@@ -25,20 +61,32 @@ Window::Window( Position const& origin
                       , Window::Color::Default)
                       )
 {
-    // Create Window Pointer
-    auto pointer = newwin(height, width, origin.y, origin.x);
+    // Create off-screen pad. Content on the screen stays until
+    // it is overwritten by the next update.
+    auto pointer = newpad(height, width);
     auto deleter = [] (CursesWnd *p)
     {
-        // Erase window content and refresh display.
-        werase(p);
-        wrefresh(p);
-
-        // Free Resources
         delwin(p);
     };
     wnd_ = std::unique_ptr<CursesWnd, CursesWndDel>(pointer, deleter);
 }
 
+void Window::resize( Position const& origin
+                    , unsigned        width
+                    , unsigned        height
+                    )
+{
+    // Pads are never drawn outside the terminal, their origin only
+    // matters on refresh.
+    wresize( wnd_.get()
+           , static_cast<int>(std::max(height, 1u))
+           , static_cast<int>(std::max(width, 1u))
+           );
+    origin_ = origin;
+    width_  = width;
+    height_ = height;
+}
+
 void Window::move_to(Position const& pos)
 {
     wmove(wnd_.get(), pos.y, pos.x);
@@ -56,39 +104,13 @@ void Window::set_background_color(Window::Color c)
 
 void Window::set_color(Window::Color fg, Window::Color bg)
 {
-    static auto color_counter = short(0);
-
     color_ = ColorPair(fg, bg);
-
-    // Lookup requested color pair. Create a new one if it cant be found.
-    if (colors_.find(color_) == colors_.cend())
-    {
-        ++color_counter;
-        colors_[color_] = color_counter;
-    }
-
-    // Setup curses color pair and enable color.
-    auto color_id = colors_[color_];
-    std::tie(fg, bg) = color_;
-
-    init_pair(color_id
-             , static_cast<short>(fg)
-             , static_cast<short>(bg)
-             );
-
-    wattron(wnd_.get(), COLOR_PAIR(color_id));
+    wattron(wnd_.get(), color_attrs[get_color_index(fg, bg)]);
 }
 
 void Window::unset_color()
 {
-    // Lookup color
-    auto const pos = colors_.find(color_);
-    if (pos == colors_.cend())
-    {
-        return;
-    }
-
-    wattroff(wnd_.get(), COLOR_PAIR(pos->second));
+    wattroff(wnd_.get(), color_attrs[get_color_index(color_.first, color_.second)]);
 }
 
 void Window::set_underlined()
@@ -103,19 +125,20 @@ void Window::unset_underlined()
 
 void Window::add_string(std::string const& str)
 {
-    add_string("%s", str.c_str());
+    add_string(str, str.size());
 }
 
 void Window::add_string(std::string const& str, std::size_t str_len)
 {
-    if (str_len < str.size())
-    {
-        add_string(std::string(str, 0, str_len));
-    }
-    else
-    {
-        add_string(str);
-    }
+    // Write characters directly, no copy and no format string
+    auto len = std::min(str.size(), str_len);
+    waddnstr(wnd_.get(), str.data(), static_cast<int>(len));
+}
+
+void Window::add_string(char const *str, std::size_t str_len)
+{
+    auto len = ::strnlen(str, str_len);
+    waddnstr(wnd_.get(), str, static_cast<int>(len));
 }
 
 void Window::add_vertical_line(unsigned len)
@@ -172,7 +195,24 @@ void Window::erase()
 
 void Window::refresh()
 {
-    wrefresh(wnd_.get());
+    if ((width_ == 0) || (height_ == 0))
+    {
+        return;
+    }
+
+    pnoutrefresh( wnd_.get()
+                , 0
+                , 0
+                , origin_.y
+                , origin_.x
+                , origin_.y + height_ - 1
+                , origin_.x + width_ - 1
+                );
+}
+
+void Window::update()
+{
+    doupdate();
 }
 
 Position Window::get_origin() const
@@ -15,7 +15,6 @@
 #define WINDOW_HPP_201804081223
 
 #include <memory>
-#include <map>
 #include <functional>
 #include <string>
 #include <cstdint>
@@ -37,7 +36,8 @@ struct Position
     }
 };
 
-// Curses wrapping window class.
+// Curses wrapping window class. Contents are drawn into an off-screen pad
+// and only copied to the screen on update().
 class Window
 {
 public:
@@ -58,6 +58,10 @@ public:
         White   = COLOR_WHITE
     };
 
+    // Register color pairs of all color combinations with curses. Call once
+    // after curses setup, setting colors afterwards only changes attributes.
+    static void init_colors();
+
     // Constructor: @p origin is the position of upper left corner of window
     // @p width and @p height are the windows height and width in terms of characters.
     Window( Position const& origin
@@ -65,6 +69,13 @@ public:
           , unsigned        height
           );
 
+    // Move window to @p origin and resize it to @p width and @p height.
+    // The window contents must be redrawn afterwards.
+    void resize( Position const& origin
+               , unsigned        width
+               , unsigned        height
+               );
+
     // Move to specific position in window, relative to the windows origin.
     void move_to(Position const& pos);
 
@@ -87,14 +98,8 @@ public:
     // Remove underlined from current attributes.
     void unset_underlined();
 
-    // Add string to current position.
-    template<typename... Args>
-    void add_string(char const *fmt, Args... args)
-    {
-        wprintw(wnd_.get(), fmt, args...);
-    }
-
-    // Add string to current position.
+    // Add string to current position. The following functions never
+    // allocate memory and never interpret the string as a format.
     void add_string(std::string const& str);
 
     // Add string with up to @p str_len characters to current position.
@@ -132,9 +137,14 @@ public:
     // Clear entire windows contents
     void erase();
 
-    // Show current window state. Changes are only visible after calling refresh.
+    // Stage current window state for the next update. Changes are only
+    // visible after calling refresh and update.
     void refresh();
 
+    // Write all staged changes of all windows to the terminal at once.
+    // Only the difference to the current terminal contents is sent.
+    static void update();
+
     // Get window origin.
     Position get_origin() const;
 
@@ -156,7 +166,6 @@ public:
 private:
     using CursesWndDel = std::function<void(CursesWnd*)>;
     using ColorPair    = std::pair<Window::Color, Window::Color>;
-    using ColorMap     = std::map<ColorPair, short>;
 
     // Handle on curses window with custom deleter for automatic cleanup.
     std::unique_ptr<CursesWnd, CursesWndDel> wnd_;
@@ -165,7 +174,6 @@ private:
     unsigned  width_;
     unsigned  height_;
     ColorPair color_;
-    ColorMap  colors_;
 };
 
 #endif // WINDOW_HPP_201804081223
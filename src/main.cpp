@@ -12,163 +12,274 @@
  */
 
 #include <vector>
+#include <iostream>
 #include <memory>
-#include <thread>
-#include <atomic>
-#include <mutex>
-#include <condition_variable>
-#include <functional>
+#include <chrono>
+#include <optional>
 #include <csignal>
-#include <host_monitor/HostMonitor.hpp>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
 #include "Args.hpp"
 #include "Config.hpp"
+#include "Constants.hpp"
+#include "FileDescriptor.hpp"
 #include "Util.hpp"
+#include "ProbeScheduler.hpp"
 #include "UserInterface.hpp"
 #include "GroupElement.hpp"
-#include "ObserverElement.hpp"
-
-using namespace host_monitor;
-
-using sec             = std::chrono::seconds;
-using msec            = std::chrono::milliseconds;
-using MonitorPtr      = std::shared_ptr<HostMonitor>;
-using ObserverPtr     = std::shared_ptr<HostMonitorObserver>;
-using MonitorObserver = std::pair<MonitorPtr, ObserverPtr>;
-using Proto           = Endpoint::Protocol;
+#include "HostTable.hpp"
 
 namespace
 {
-    // Workaround to use capture list in signal handling
-    std::function<void(int)> signal_handler;
-}
+    using Clock = std::chrono::steady_clock;
 
-Endpoint make_endpoint(ConfigHost const& host)
-{
-    auto proto = string_to_protocol(host.protocol);
+    // Epoll tokens of the event sources of the main loop.
+    std::uint64_t const signal_token = 0;
+    std::uint64_t const timer_token  = 1;
+    std::uint64_t const input_token  = 2;
+    std::uint64_t const event_token  = 3;
 
-    switch (proto.value())
+    // Add @p fd to @p epoll, reporting @p events with @p token.
+    void watch_fd(int epoll, int fd, std::uint32_t events, std::uint64_t token)
     {
-        case Proto::ICMPV4:
-            return Endpoint::make_icmpv4_endpoint(host.fqhn);
-        case Proto::ICMPV6:
-            return Endpoint::make_icmpv6_endpoint(host.fqhn);
-        case Proto::TCP:
-            return Endpoint::make_tcp_endpoint(host.fqhn, host.port.value());
+        auto ev = epoll_event();
+        ev.events   = events;
+        ev.data.u64 = token;
+        if (::epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &ev) < 0)
+        {
+            abort("Failed to setup main loop");
+        }
     }
 
-    throw std::runtime_error("Invalid Given Protocol. Abort.");
-}
-
-int main(int argc, char **argv)
-{
-    // Synchronization primitives
-    auto mtx = std::mutex();
-    auto cv  = std::condition_variable();
-
-    auto shutdown_ui = std::atomic_bool(false);
-    auto rebuild_ui  = std::atomic_bool(false);
-    auto redraw_ui   = std::atomic_bool(true);
+    // Remove @p fd from @p epoll.
+    void unwatch_fd(int epoll, int fd)
+    {
+        if (::epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr) < 0)
+        {
+            abort("Failed to update main loop");
+        }
+    }
 
-    // Setup Signal Handling
-    signal_handler = [&mtx, &cv, &shutdown_ui, &rebuild_ui] (int signo)
+    // Arm timerfd @p fd to expire at @p deadline, disarm it without one.
+    // The steady clock is the monotonic clock of the timerfd.
+    void arm_timer(int fd, std::optional<Clock::time_point> const& deadline)
     {
-        switch(signo)
+        auto spec = itimerspec();
+        if (deadline)
         {
-            case SIGINT:
-            {
-                auto lock = std::lock_guard<std::mutex>(mtx);
-                shutdown_ui = true;
-                cv.notify_one();
-                break;
-            }
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline->time_since_epoch()).count();
+            spec.it_value.tv_sec  = static_cast<time_t>(ns / 1000000000);
+            spec.it_value.tv_nsec = static_cast<long>(ns % 1000000000);
 
-            case SIGWINCH:
+            // A zero value disarms, expire right away instead.
+            if ((spec.it_value.tv_sec == 0) && (spec.it_value.tv_nsec == 0))
             {
-                auto lock = std::lock_guard<std::mutex>(mtx);
-                rebuild_ui = true;
-                cv.notify_one();
-                break;
+                spec.it_value.tv_nsec = 1;
             }
-            default:
-                return;
         }
-    };
-    std::signal(SIGINT,   [] (int signo) {signal_handler(signo);});
-    std::signal(SIGWINCH, [] (int signo) {signal_handler(signo);});
+        ::timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    auto shutdown_ui = false;
+    auto redraw_ui   = true;
+    auto pending     = false;
+    auto resize_at   = std::optional<Clock::time_point>();
+
+    // Block signals before any thread is started, all threads inherit the
+    // mask. Signals are read from a signalfd by the main loop, there is no
+    // code running in signal context.
+    auto signals = sigset_t();
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    sigaddset(&signals, SIGWINCH);
+    ::pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    auto signal_fd = FileDescriptor(::signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC));
+    auto timer_fd  = FileDescriptor(::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC));
+    auto epoll_fd  = FileDescriptor(::epoll_create1(EPOLL_CLOEXEC));
+    if (!signal_fd.is_valid() || !timer_fd.is_valid() || !epoll_fd.is_valid())
+    {
+        abort("Failed to setup main loop");
+    }
 
     // Parse given arguments and read config file
     auto args   = read_args(argc, argv);
     auto config = read_config_file(args["-f"]);
 
-    auto attached_observers = std::vector<MonitorObserver>();
-    auto group_elements     = std::vector<GroupElement::Pointer>();
+    // Report config memory instead of monitoring
+    if (args.count("--stats"))
+    {
+        print_config_stats(std::cout, config);
+        return 0;
+    }
+
+    // State of all hosts. Changed hosts are queued without locking,
+    // each host at most once.
+    auto host_count = std::size_t(0);
+    for (auto const& grp : config.groups)
+    {
+        host_count += grp.hosts.size();
+    }
+
+    auto hosts   = HostTable(config.global.field_format, config.strings, host_count);
+    auto redrawn = HostTable::Changed();
+    redrawn.reserve(host_count);
+
+    auto backend        = config.global.probe_backend.value_or(Backend::Epoll);
+    auto lookup         = config.global.hosts_file
+                        ? make_hosts_file_lookup(config.global.hosts_file.value())
+                        : Resolver::Lookup(resolve_address);
+    auto confirm        = make_probe_confirm(config.global);
+    auto limits         = make_probe_limits(config.global);
+    auto scheduler      = ProbeScheduler(probe_worker_count, backend, lookup, confirm, limits);
+    auto frame_rate     = config.global.frame_rate.value_or(ui_frame_rate);
+    auto frame_time     = Clock::duration(std::chrono::seconds(1)) / frame_rate;
+    auto next_frame     = Clock::now();
+    auto group_elements = std::vector<GroupElement::Pointer>();
 
     // Setup Groups and Monitoring
-    for (auto grp : config.groups)
+    for (auto const& grp : config.groups)
     {
-        auto observers = std::vector<ObserverElement::Pointer>();
+        auto first = hosts.size();
 
-        // Make host monitors and associated observers from this config group
+        // Make probes and associated hosts from this config group
         for (auto const& host : grp.hosts)
         {
-            // Create Host Monitor and Observers
-            auto endpoint = make_endpoint(host);
-            auto interval = sec(string_to_int(host.interval).value());
-            auto monitor  = std::make_shared<HostMonitor>(endpoint, interval);
-            auto observer = std::make_shared<ObserverElement>( host
-                                                             , config.global.field_format
-                                                             , mtx
-                                                             , cv
-                                                             , redraw_ui
-                                                             );
-
-            // Attach observer and store association for later cleanup
-            monitor->add_observer(observer);
-            attached_observers.push_back(MonitorObserver(monitor, observer));
-            observers.push_back(observer);
+            // Create Probe and its Observer
+            auto target   = make_probe_target(host, config.strings);
+            auto interval = make_probe_interval(host);
+            auto index    = hosts.add_host(host);
+
+            // All probes are driven by the central scheduler. Hosts
+            // listed in several groups are probed only once.
+            scheduler.add_probe(target, interval, hosts.make_observer(index));
         }
 
         // Create ui group from config group
-        group_elements.push_back(std::make_shared<GroupElement>(grp.name, observers));
+        group_elements.push_back(std::make_shared<GroupElement>(grp.name, hosts, first, hosts.size()));
     }
 
     // Setup and run curses ui
-    auto ui = UserInterface(group_elements, config.global.field_format);
+    auto layout = config.global.layout.value_or(Layout::List);
+    auto ui     = UserInterface(group_elements, hosts, config.global.field_format, layout);
+
+    // All wakeups of the main thread go through a single epoll: Signals, the
+    // render timer, key input and changed hosts. The queue signals once
+    // until it is drained, edge triggering keeps pending changes from waking
+    // the loop again while the next frame is not due.
+    watch_fd(epoll_fd.get(), signal_fd.get(),   EPOLLIN,           signal_token);
+    watch_fd(epoll_fd.get(), timer_fd.get(),    EPOLLIN,           timer_token);
+    watch_fd(epoll_fd.get(), STDIN_FILENO,      EPOLLIN,           input_token);
+    watch_fd(epoll_fd.get(), hosts.get_fd(),    EPOLLIN | EPOLLET, event_token);
+    scheduler.start();
 
     // Main thread processing loop.
     while (shutdown_ui != true)
     {
-        // Rebuild ui (caused by terminal resize), implies redraw.
-        if (rebuild_ui)
+        auto now = Clock::now();
+
+        // Resize ui once the terminal size settled, implies redraw. Dragging
+        // a terminal edge causes many resizes in a row.
+        if (resize_at && (resize_at.value() <= now))
         {
-            rebuild_ui = false;
-            ui.rebuild_ui();
+            resize_at.reset();
+            ui.resize_ui();
             redraw_ui = true;
         }
 
-        // Internal state of the shown observers changed. Redraw ui
+        // Limit frame rate. Changes arriving until the next frame
+        // is due are drawn together.
+        if (pending && (next_frame <= now))
+        {
+            pending    = false;
+            next_frame = now + frame_time;
+            hosts.drain([&redrawn] (HostTable::Index host) {redrawn.push_back(host);});
+        }
+
+        // Draw entire ui on startup, after a resize and after scrolling
         if (redraw_ui)
         {
             redraw_ui = false;
             ui.draw();
         }
 
+        // Internal state of some hosts changed. Redraw only their status.
+        ui.draw_changes(redrawn);
+        redrawn.clear();
+
+        // Wake up for the earliest of the due frame and the resize
+        auto deadline = resize_at;
+        if (pending && (!deadline || (next_frame < deadline.value())))
+        {
+            deadline = next_frame;
+        }
+        arm_timer(timer_fd.get(), deadline);
+
         // Wait until any of the following conditions is true
-        // 1) Shutdown is true (set by signal handler)
-        // 2) ui must be rebuilt (set by signal handler)
-        // 3) ui must be redrawn (set by observer state change)
-        auto lock = std::unique_lock<std::mutex>(mtx);
-        auto cond = [&shutdown_ui, &rebuild_ui, &redraw_ui]
+        // 1) A signal arrived: Shutdown or resize
+        // 2) The next frame or the resize is due
+        // 3) Key input is available
+        // 4) Hosts changed (pushed by probe results)
+        epoll_event events[4];
+        auto count = ::epoll_wait(epoll_fd.get(), events, 4, -1);
+
+        for (auto i = 0; i < count; ++i)
+        {
+            switch (events[i].data.u64)
             {
-                return (shutdown_ui || rebuild_ui || redraw_ui);
-            };
-        cv.wait(lock, cond);
-    }
+                case signal_token:
+                {
+                    auto info = signalfd_siginfo();
+                    while (::read(signal_fd.get(), &info, sizeof(info)) == sizeof(info))
+                    {
+                        if (info.ssi_signo == SIGWINCH)
+                        {
+                            resize_at = Clock::now() + std::chrono::milliseconds(ui_resize_delay_ms);
+                        }
+                        else
+                        {
+                            shutdown_ui = true;
+                        }
+                    }
+                    break;
+                }
 
-    // Cleanup: Detach attached Observers
-    for (auto [monitor, observer] : attached_observers)
-    {
-        monitor->del_observer(observer);
+                case timer_token:
+                    clear_event(timer_fd.get());
+                    break;
+
+                // Scroll and switch layouts on key input. Stdin is level
+                // triggered, stop watching it once it is closed.
+                case input_token:
+                {
+                    auto closed = (events[i].events & (EPOLLHUP | EPOLLERR)) != 0;
+                    redraw_ui |= ui.handle_input(closed);
+                    if (closed)
+                    {
+                        unwatch_fd(epoll_fd.get(), STDIN_FILENO);
+                    }
+                    break;
+                }
+
+                case event_token:
+                    pending = true;
+                    break;
+
+                default:
+                    break;
+            }
+        }
     }
+
+    // Cleanup: Stop probing before the observers go away
+    scheduler.stop();
     return 0;
 }
@@ -0,0 +1,291 @@
+/**
+ * @file      ProbeSchedulerTest.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Confirmation of state changes by the probe scheduler.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+#include <sys/socket.h>
+#include "Address.hpp"
+#include "Constants.hpp"
+#include "Probe.hpp"
+#include "ProbeEngine.hpp"
+#include "ProbeScheduler.hpp"
+
+using namespace std::chrono;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// Time to wait for an expected result before giving up.
+auto const wait_timeout = seconds(15);
+
+// Answers each probe immediately with the next result of a script.
+// Once the script is exhausted, its last result is repeated.
+class ScriptedEngine : public ProbeEngine
+{
+public:
+    ScriptedEngine(Completion completion, std::vector<bool> script)
+        : completion_(std::move(completion))
+        , script_(std::move(script))
+        , mtx_()
+        , submits_()
+    {
+    }
+
+    virtual void submit(std::vector<ProbeRequest> const& requests) override
+    {
+        for (auto const& request : requests)
+        {
+            auto available = false;
+            {
+                auto lock = std::lock_guard<std::mutex>(mtx_);
+                available = script_[std::min(submits_.size(), script_.size() - 1)];
+                submits_.push_back(Clock::now());
+            }
+            completion_(request.id, ProbeResult{available, microseconds(100)});
+        }
+    }
+
+    // Get start times of all probes so far.
+    std::vector<Clock::time_point> get_submits()
+    {
+        auto lock = std::lock_guard<std::mutex>(mtx_);
+        return submits_;
+    }
+
+private:
+    Completion                     completion_;
+    std::vector<bool>              script_;
+    std::mutex                     mtx_;
+    std::vector<Clock::time_point> submits_;
+};
+
+// Records all reported results.
+class Recorder : public ProbeObserver
+{
+public:
+    struct Report
+    {
+        Clock::time_point time;
+        bool              available;
+    };
+
+    virtual void probe_finished(ProbeResult const& result) override
+    {
+        auto lock = std::lock_guard<std::mutex>(mtx_);
+        reports_.push_back(Report{Clock::now(), result.available});
+        cv_.notify_all();
+    }
+
+    // Wait until @p count results were reported. Returns all of them.
+    std::vector<Report> wait_for(std::size_t count)
+    {
+        auto lock = std::unique_lock<std::mutex>(mtx_);
+        cv_.wait_for(lock, wait_timeout, [this, count] { return reports_.size() >= count; });
+        return reports_;
+    }
+
+private:
+    std::mutex              mtx_;
+    std::condition_variable cv_;
+    std::vector<Report>     reports_;
+};
+
+// Make scheduler probing @p hosts hosts within @p limits. Its engine answers
+// with @p script and is stored in @p engine, the results are recorded by @p recorder.
+std::unique_ptr<ProbeScheduler> make_scheduler( ProbeConfirm                     confirm
+                                              , ProbeInterval                    interval
+                                              , std::vector<bool> const&         script
+                                              , std::shared_ptr<ScriptedEngine>& engine
+                                              , std::shared_ptr<Recorder>&       recorder
+                                              , ProbeLimits                      limits = ProbeLimits{0, 0, false}
+                                              , unsigned                         hosts  = 1
+                                              )
+{
+    auto make_engines = [&engine, script] (ProbeEngine::Completion completion)
+    {
+        engine = std::make_shared<ScriptedEngine>(completion, script);
+        return ProbeScheduler::Engines(engine, engine);
+    };
+    auto lookup = [] (std::string const& fqhn, int family)
+    {
+        return resolve_address(fqhn, family);
+    };
+
+    auto scheduler = std::make_unique<ProbeScheduler>( 1
+                                                     , make_engines
+                                                     , lookup
+                                                     , confirm
+                                                     , limits
+                                                     );
+
+    recorder = std::make_shared<Recorder>();
+    for (auto i = 1u; i <= hosts; ++i)
+    {
+        auto target = ProbeTarget{ Protocol::Tcp
+                                 , Resolver::Name("127.0.0." + std::to_string(i), AF_INET)
+                                 , 80
+                                 , milliseconds(probe_timeout_ms)
+                                 , milliseconds(probe_max_timeout_ms)
+                                 };
+        scheduler->add_probe(target, interval, recorder);
+    }
+    return scheduler;
+}
+
+// Get ticks of the scheduler between @p from and @p to.
+long to_ticks(Clock::time_point from, Clock::time_point to)
+{
+    return static_cast<long>(duration_cast<milliseconds>(to - from).count() / probe_tick_ms);
+}
+
+unsigned failures = 0;
+
+void expect(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        std::cout << "    FAILED: " << what << "\n";
+        failures += 1;
+    }
+}
+
+// A host goes down. The change is reported after the confirming retries,
+// the first down probe and its report are retries * spacing apart.
+void test_confirmed_change(ProbeConfirm confirm)
+{
+    auto engine    = std::shared_ptr<ScriptedEngine>();
+    auto recorder  = std::shared_ptr<Recorder>();
+    auto interval  = ProbeInterval{seconds(1), seconds(1), seconds(1)};
+    auto scheduler = make_scheduler(confirm, interval, {true, false}, engine, recorder);
+
+    scheduler->start();
+    auto reports = recorder->wait_for(2);
+    scheduler->stop();
+
+    auto submits  = engine->get_submits();
+    auto retries  = static_cast<long>(confirm.retries);
+    auto expected = retries * static_cast<long>(confirm.spacing.count() / probe_tick_ms);
+
+    expect(reports.size() >= 2, "Change was reported");
+    expect(submits.size() >= 2 + confirm.retries, "Change was confirmed by all retries");
+    if ((reports.size() < 2) || (submits.size() < 2))
+    {
+        return;
+    }
+
+    // The wheel rounds each retry to its tick, it may fire up to a tick early
+    // and a tick late, plus a tick of wakeup latency.
+    auto ticks = to_ticks(submits[1], reports[1].time);
+    std::cout << "    retries " << confirm.retries << ", spacing " << confirm.spacing.count()
+              << " ms: " << ticks << " ticks, expected " << expected << "\n";
+
+    expect(reports[0].available, "First report is up");
+    expect(!reports[1].available, "Second report is down");
+    expect(ticks >= expected - retries, "Change isn't reported before its retries");
+    expect(ticks <= expected + 2 * retries + 1, "Change is reported right after its retries");
+}
+
+// A single failed probe is rejected by a retry. The interval stays as it
+// was before the blip instead of doubling.
+void test_rejected_blip()
+{
+    auto engine    = std::shared_ptr<ScriptedEngine>();
+    auto recorder  = std::shared_ptr<Recorder>();
+    auto confirm   = ProbeConfirm{1, milliseconds(100)};
+    auto interval  = ProbeInterval{seconds(1), seconds(1), seconds(4)};
+    auto script    = std::vector<bool>{true, true, false, true};
+    auto scheduler = make_scheduler(confirm, interval, script, engine, recorder);
+
+    // Probes: up, up (interval doubles to 2s), down, retry up, up
+    scheduler->start();
+    auto reports = recorder->wait_for(4);
+    scheduler->stop();
+
+    auto submits = engine->get_submits();
+    expect(reports.size() >= 4, "All probes were reported");
+    expect(submits.size() >= 5, "All probes were started");
+    if (submits.size() < 5)
+    {
+        return;
+    }
+
+    auto ticks = to_ticks(submits[3], submits[4]);
+    std::cout << "    interval after blip: " << ticks << " ticks, expected "
+              << 2000 / probe_tick_ms << "\n";
+
+    for (auto const& report : reports)
+    {
+        expect(report.available, "Blip isn't reported");
+    }
+    expect(to_ticks(submits[2], submits[3]) <= 100 / probe_tick_ms + 2, "Blip is retried quickly");
+    expect(ticks >= 2000 / probe_tick_ms - 2, "Interval isn't reset by the blip");
+    expect(ticks <= 2000 / probe_tick_ms + 2, "Interval doesn't double after the blip");
+}
+// Probes exceeding the rate limit are delayed until their turn. The bucket
+// starts full, afterwards probes start at the limited rate.
+void test_rate_limit()
+{
+    auto engine    = std::shared_ptr<ScriptedEngine>();
+    auto recorder  = std::shared_ptr<Recorder>();
+    auto confirm   = ProbeConfirm{0, milliseconds(100)};
+    auto interval  = ProbeInterval{seconds(60), seconds(60), seconds(60)};
+    auto limits    = ProbeLimits{50, 0, false};
+    auto scheduler = make_scheduler(confirm, interval, {true}, engine, recorder, limits, 150);
+
+    scheduler->start();
+    auto reports = recorder->wait_for(150);
+    scheduler->stop();
+
+    auto submits = engine->get_submits();
+    expect(submits.size() == 150, "All probes were started once");
+    if (submits.size() != 150)
+    {
+        return;
+    }
+
+    // 50 probes at once, then 100 probes at 50 per second
+    auto burst = to_ticks(submits[0], submits[49]);
+    auto ticks = to_ticks(submits[0], submits[149]);
+    std::cout << "    150 probes at 50/s: first 50 within " << burst << " ticks, all within "
+              << ticks << " ticks, expected " << 2000 / probe_tick_ms << "\n";
+
+    expect(burst <= 2, "Full bucket passes at once");
+    expect(ticks >= 2000 / probe_tick_ms - 2, "Rate limit is kept");
+    expect(ticks <= 2000 / probe_tick_ms + 5, "Delayed probes start in their turn");
+}
+} // namespace
+
+int main()
+{
+    std::cout << "Confirmed state change:\n";
+    test_confirmed_change(ProbeConfirm{0, milliseconds(100)});
+    test_confirmed_change(ProbeConfirm{2, milliseconds(100)});
+    test_confirmed_change(ProbeConfirm{3, milliseconds(50)});
+
+    std::cout << "Rejected blip:\n";
+    test_rejected_blip();
+
+    std::cout << "Rate limit:\n";
+    test_rate_limit();
+
+    std::cout << (failures ? "FAILED" : "PASSED") << "\n";
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,226 @@
+/**
+ * @file      ResolverTest.cpp
+ * @author    Simon Brummer (<simon.brummer@posteo.de>)
+ * @brief     Caching, refreshing and expiry of resolved names.
+ * @copyright 2018 Simon Brummer. All rights reserved.
+ */
+
+/*
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "Address.hpp"
+#include "Resolver.hpp"
+#include "Util.hpp"
+
+using namespace std::chrono;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// Time to wait for an expected address before giving up.
+auto const wait_timeout = seconds(5);
+
+// Resolves from one of two hosts files, the test switches between them.
+// Each file maps "web" to another address and "old" only exists in the first.
+class HostsFiles
+{
+public:
+    HostsFiles()
+        : first_(write("10.0.0.1 web\n10.0.0.3 old\n"))
+        , second_(write("10.0.0.2 web # moved\n"))
+        , use_second_(false)
+        , lookups_(0)
+    {
+    }
+
+    ~HostsFiles()
+    {
+        ::unlink(first_.c_str());
+        ::unlink(second_.c_str());
+    }
+
+    // Make lookup of the file in use.
+    Resolver::Lookup make_lookup()
+    {
+        auto first  = make_hosts_file_lookup(first_);
+        auto second = make_hosts_file_lookup(second_);
+        return [this, first, second] (std::string const& fqhn, int family)
+        {
+            lookups_ += 1;
+            return use_second_ ? second(fqhn, family) : first(fqhn, family);
+        };
+    }
+
+    void use_second(bool use)
+    {
+        use_second_ = use;
+    }
+
+    unsigned get_lookups() const
+    {
+        return lookups_;
+    }
+
+private:
+    static std::string write(char const* content)
+    {
+        static auto count = 0;
+        auto path = std::string("/tmp/resolver_test.") + std::to_string(::getpid())
+                  + "." + std::to_string(count++);
+        auto file = std::ofstream(path);
+        file << content;
+        if (!file)
+        {
+            abort("Failed to write hosts file");
+        }
+        return path;
+    }
+
+    std::string           first_;
+    std::string           second_;
+    std::atomic_bool      use_second_;
+    std::atomic<unsigned> lookups_;
+};
+
+unsigned failures = 0;
+
+void expect(bool condition, char const* what)
+{
+    if (!condition)
+    {
+        std::cout << "    FAILED: " << what << "\n";
+        failures += 1;
+    }
+}
+
+bool is_address(std::optional<Address> const& addr, char const* expected)
+{
+    return addr && (address_to_string(addr.value()) == expected);
+}
+
+// Poll lookup of @p name until it returns @p expected. Returns the time it took.
+std::optional<Clock::duration> wait_for(Resolver& resolver, Resolver::Name const& name, char const* expected)
+{
+    auto start = Clock::now();
+    while ((Clock::now() - start) < wait_timeout)
+    {
+        if (is_address(resolver.lookup(name), expected))
+        {
+            return Clock::now() - start;
+        }
+        std::this_thread::sleep_for(milliseconds(10));
+    }
+    return {};
+}
+
+long to_ms(Clock::duration duration)
+{
+    return static_cast<long>(duration_cast<milliseconds>(duration).count());
+}
+
+// Resolved names are cached, unknown ones are cached as unresolvable.
+void test_hit_and_miss()
+{
+    auto files    = HostsFiles();
+    auto resolver = Resolver(1, seconds(60), seconds(60), files.make_lookup());
+    auto web      = Resolver::Name("web", AF_INET);
+    auto web6     = Resolver::Name("web", AF_INET6);
+    auto missing  = Resolver::Name("missing", AF_INET);
+
+    resolver.resolve({web, web6, missing});
+    expect(files.get_lookups() == 3, "Each name is resolved once");
+    expect(is_address(resolver.lookup(web), "10.0.0.1"), "Listed name is a hit");
+    expect(!resolver.lookup(web6), "Other family is a miss");
+    expect(!resolver.lookup(missing), "Unlisted name is a miss");
+
+    resolver.resolve({web, web6, missing});
+    resolver.lookup(web);
+    resolver.lookup(missing);
+    expect(files.get_lookups() == 3, "Cached names are not resolved again");
+}
+
+// Addresses are resolved again before they expire. Lookups keep returning
+// the cached address until the new one arrived.
+void test_refresh()
+{
+    auto files    = HostsFiles();
+    auto resolver = Resolver(1, seconds(1), seconds(60), files.make_lookup());
+    auto web      = Resolver::Name("web", AF_INET);
+
+    resolver.resolve({web});
+    files.use_second(true);
+
+    auto gaps  = 0u;
+    auto start = Clock::now();
+    auto took  = std::optional<Clock::duration>();
+    while (!took && ((Clock::now() - start) < wait_timeout))
+    {
+        auto addr = resolver.lookup(web);
+        gaps += addr ? 0 : 1;
+        if (is_address(addr, "10.0.0.2"))
+        {
+            took = Clock::now() - start;
+        }
+        std::this_thread::sleep_for(milliseconds(10));
+    }
+
+    std::cout << "    ttl 1000 ms: refreshed after " << (took ? to_ms(took.value()) : -1)
+              << " ms, expected 800\n";
+    expect(took && (took.value() < seconds(1)), "Address is refreshed before it expires");
+    expect(gaps == 0, "Lookups never miss while refreshing");
+}
+
+// A failed refresh keeps the address until it expires. An expired address
+// is resolved again on lookup instead of waiting for the negative ttl.
+void test_expiry()
+{
+    auto files    = HostsFiles();
+    auto resolver = Resolver(1, seconds(1), seconds(60), files.make_lookup());
+    auto old      = Resolver::Name("old", AF_INET);
+
+    resolver.resolve({old});
+    files.use_second(true);
+
+    // The refresh at 800 ms fails, the address is kept until 1000 ms
+    std::this_thread::sleep_for(milliseconds(900));
+    expect(is_address(resolver.lookup(old), "10.0.0.3"), "Failed refresh keeps the address");
+
+    std::this_thread::sleep_for(milliseconds(200));
+    files.use_second(false);
+    expect(!resolver.lookup(old), "Expired address is not returned");
+
+    auto took = wait_for(resolver, old, "10.0.0.3");
+    std::cout << "    negative ttl 60 s: resolved again " << (took ? to_ms(took.value()) : -1)
+              << " ms after expiry, expected 0\n";
+    expect(took && (took.value() < milliseconds(500)), "Expired address is resolved on lookup");
+}
+} // namespace
+
+int main()
+{
+    std::cout << "Hit and miss:\n";
+    test_hit_and_miss();
+
+    std::cout << "Refresh:\n";
+    test_refresh();
+
+    std::cout << "Expiry:\n";
+    test_expiry();
+
+    std::cout << (failures ? "FAILED" : "PASSED") << "\n";
+    return failures ? 1 : 0;
+}